@@ -1,19 +1,53 @@
 /** @file   eeprom.c
     @author M. P. Hayes, UCECE
     @date   15 May 2007
-    @brief 
+    @brief
+
+    Asynchronous writes are kept in a ring buffer that is drained by
+    the EEPROM ready interrupt.  The main program adds to the tail and
+    the interrupt handler removes from the head.  The queue is only
+    searched or changed with interrupts disabled so that a byte cannot
+    be taken by the handler while it is being updated.
+
+    Queueing a byte does not read the EEPROM, since a read has to wait
+    for the write in progress.  Instead the handler reads each cell
+    just before writing it, when the last write has finished, and
+    skips the write if the cell already holds the value.
 */
 #include "system.h"
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include "eeprom.h"
 
+#define EEPROM_QUEUE_MASK (EEPROM_QUEUE_SIZE - 1)
+
+
+typedef struct
+{
+    eeprom_addr_t addr;
+    uint8_t data;
+} eeprom_queue_t;
+
+
+static volatile eeprom_queue_t queue[EEPROM_QUEUE_SIZE];
+static volatile uint8_t queue_head;
+static volatile uint8_t queue_tail;
+
+
 static void
 eeprom_write_byte (eeprom_addr_t addr, uint8_t data)
 {
+    uint8_t sreg;
+
     /* Wait for completion of previous write.  */
     while (EECR & _BV (EEPE))
         continue;
 
+    /* EEPE must be set within four cycles of EEMPE so an interrupt
+       cannot be allowed between them.  */
+    sreg = SREG;
+    cli ();
+
     /* Set up address and data registers */
     EEAR = addr;
     EEDR = data;
@@ -22,18 +56,17 @@ eeprom_write_byte (eeprom_addr_t addr, uint8_t data)
 
     /* Start eeprom write.  */
     EECR |= _BV (EEPE);
+
+    SREG = sreg;
 }
 
 
+/* Read a byte.  No write can be in progress.  */
 static uint8_t eeprom_read_byte (eeprom_addr_t addr)
 {
-    /* Wait for completion of previous write.  */
-    while (EECR & _BV (EEPE))
-        continue;
-
     /* Set up address register */
     EEAR = addr;
-    
+
     /* Start eeprom read.  */
     EECR |= _BV (EERE);
 
@@ -42,30 +75,187 @@ static uint8_t eeprom_read_byte (eeprom_addr_t addr)
 }
 
 
+/* Find the newest queued write to ADDR.  Interrupts must be disabled.
+   Return its index or -1 if there is none.  */
+static int8_t
+eeprom_queue_find (eeprom_addr_t addr)
+{
+    uint8_t i;
+
+    for (i = queue_tail; i != queue_head; )
+    {
+        i--;
+        if (queue[i & EEPROM_QUEUE_MASK].addr == addr)
+            return i & EEPROM_QUEUE_MASK;
+    }
+    return -1;
+}
+
+
+ISR (EE_READY_vect)
+{
+    uint8_t i;
+
+    /* The ready interrupt means the last write has finished, so the
+       cells can be read without waiting.  */
+    while (queue_head != queue_tail)
+    {
+        i = queue_head & EEPROM_QUEUE_MASK;
+        queue_head++;
+
+        EEAR = queue[i].addr;
+        EECR |= _BV (EERE);
+        if (EEDR == queue[i].data)
+            continue;
+
+        /* EEMPE must be followed by EEPE within four cycles, which
+           holds since interrupts are disabled here.  */
+        EEDR = queue[i].data;
+        EECR |= _BV (EEMPE);
+        EECR |= _BV (EEPE);
+        return;
+    }
+
+    /* Nothing left to write.  */
+    EECR &= ~_BV (EERIE);
+}
+
+
 /* Read SIZE bytes from ADDR into BUFFER.  */
 eeprom_size_t
 eeprom_read (eeprom_addr_t addr, void *buffer, eeprom_size_t size)
 {
     eeprom_size_t i;
     uint8_t *data = buffer;
+    uint8_t sreg;
+    uint8_t ready;
+    bool waited = 0;
+
+    /* Hold off the ready interrupt so that once the write in progress
+       has finished no other starts until all the bytes are read.
+       Other interrupts are left enabled.  */
+    sreg = SREG;
+    cli ();
+    ready = EECR & _BV (EERIE);
+    EECR &= ~_BV (EERIE);
+    SREG = sreg;
 
     for (i = 0; i < size; i++)
-        data[i] = eeprom_read_byte (addr++);
+    {
+        int8_t pending;
 
-    return i;
+        sreg = SREG;
+        cli ();
+        pending = eeprom_queue_find (addr);
+        if (pending >= 0)
+            data[i] = queue[pending].data;
+        SREG = sreg;
+
+        /* With no write queued, the EEPROM holds the latest value
+           once any write in progress finishes.  */
+        if (pending < 0)
+        {
+            if (!waited)
+            {
+                while (EECR & _BV (EEPE))
+                    continue;
+                waited = 1;
+            }
+            data[i] = eeprom_read_byte (addr);
+        }
+
+        addr++;
+    }
+
+    sreg = SREG;
+    cli ();
+    EECR |= ready;
+    SREG = sreg;
 
+    return i;
 }
 
 
 /* Write SIZE bytes to ADDR from BUFFER.  */
-eeprom_size_t 
+eeprom_size_t
 eeprom_write (eeprom_addr_t addr, const void *buffer, eeprom_size_t size)
 {
     eeprom_size_t i;
     const uint8_t *data = buffer;
 
+    /* Keep the order of writes to the same address.  */
+    eeprom_flush ();
+
     for (i = 0; i < size; i++)
         eeprom_write_byte (addr++, data[i]);
 
     return i;
 }
+
+
+/** Queue SIZE bytes from BUFFER to be written to ADDR without
+    waiting.
+    @return number of bytes accepted.  */
+eeprom_size_t
+eeprom_write_async (eeprom_addr_t addr, const void *buffer, eeprom_size_t size)
+{
+    eeprom_size_t i;
+    const uint8_t *data = buffer;
+
+    for (i = 0; i < size; i++, addr++)
+    {
+        uint8_t sreg;
+        int8_t pending;
+        bool full;
+
+        /* Replace a write that has not started yet.  */
+        sreg = SREG;
+        cli ();
+        pending = eeprom_queue_find (addr);
+        if (pending >= 0)
+            queue[pending].data = data[i];
+        SREG = sreg;
+        if (pending >= 0)
+            continue;
+
+        sreg = SREG;
+        cli ();
+        full = (uint8_t)(queue_tail - queue_head) >= EEPROM_QUEUE_SIZE;
+        if (!full)
+        {
+            queue[queue_tail & EEPROM_QUEUE_MASK].addr = addr;
+            queue[queue_tail & EEPROM_QUEUE_MASK].data = data[i];
+            queue_tail++;
+            EECR |= _BV (EERIE);
+        }
+        SREG = sreg;
+
+        if (full)
+            break;
+    }
+
+    if (queue_head != queue_tail)
+        sei ();
+
+    return i;
+}
+
+
+/** Return non-zero when all queued writes have finished.  */
+bool
+eeprom_write_done_p (void)
+{
+    return queue_head == queue_tail && !(EECR & _BV (EEPE));
+}
+
+
+/** Wait for all queued writes to finish.  */
+void
+eeprom_flush (void)
+{
+    if (queue_head != queue_tail)
+        sei ();
+
+    while (!eeprom_write_done_p ())
+        continue;
+}
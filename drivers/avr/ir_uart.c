@@ -7,7 +7,6 @@
 #include "usart1.h"
 #include "timer0.h"
 #include "pio.h"
-#include "delay.h"
 
 
 /* Return non-zero if there is a character ready to be read.  */
@@ -27,6 +26,29 @@ ir_uart_getc (void)
 }
 
 
+/** Read up to size bytes received from IR_UART.  This does not block.
+    @param data buffer to fill
+    @param size maximum number of bytes to read
+    @return number of bytes read.  */
+uint8_t
+ir_uart_read (void *data, uint8_t size)
+{
+    return usart1_read (data, size);
+}
+
+
+/** Write up to size bytes to IR_UART.  This does not block; the bytes
+    are sent in the background and their echoes discarded.
+    @param data bytes to write
+    @param size number of bytes to write
+    @return number of bytes written.  */
+uint8_t
+ir_uart_write (const void *data, uint8_t size)
+{
+    return usart1_write (data, size);
+}
+
+
 /* Return non-zero if a character can be written without blocking.  */
 bool
 ir_uart_write_ready_p (void)
@@ -44,8 +66,8 @@ ir_uart_write_finished_p (void)
 
 
 /** Write character to IR_UART.  This blocks until the character can
-    be written into the transmit buffer.  It does not check to see
-    if there is any echoed character (see ir_uart_putc).  */
+    be written into the transmit buffer.  This is the same as
+    ir_uart_putc now that echoes are discarded on reception.  */
 void
 ir_uart_putc_nocheck (char ch)
 {
@@ -53,42 +75,22 @@ ir_uart_putc_nocheck (char ch)
 }
 
 
-/** Write character to IR_UART.  This blocks until the character is
-    written.  It then checks if data has been received and if so, reads
-    the data and throws it away on the assumption that it is electrical
-    or optical echoing.  */
+/** Write character to IR_UART.  This blocks until the character can
+    be written into the transmit buffer.  At 2400 baud with one start
+    bit, 8 data bits, and no parity, each character takes 3.75 ms to
+    transmit.  Note, the maximum bit rate for the IR receiver is 4000
+    bps.
+
+    The character is often echoed back to our own receiver.  This is
+    due to an electrical common-path interference problem caused by a
+    poor PCB layout of the track powering the IR receiver, or to an
+    optical reflection.  It does not always occur, so the USART1
+    receive interrupt discards a received character only if it matches
+    one sent within the last few character times.  */
 void
 ir_uart_putc (char ch)
 {
-    /* At 2400 baud with one start bit, 8 data bits, and no parity,
-       this will take 3.75 ms to transmit.  Note, the maximum bit rate
-       for the IR receiver is 4000 bps. */
     usart1_putc (ch);
-
-    /* Gobble echoed character.  The echoing is due to an electrical
-       common-path interference problem caused by a poor PCB layout of the
-       track powering the IR receiver.  Unfortunately, it does not always
-       occur with some combination of UCFK4 boards and laptops.  Perhaps
-       some laptops are more miserly with their current allocation and
-       some IR LEDs do not draw as much current?  So as a workaround
-       we need to wait until the transmission has finished and then check
-       if something was immediately received. 
-
-       Having said all this, it is possible to get an optical reflection
-       of the transmitted signal.  The following code should handle this 
-       as well.  */
-
-    while (! ir_uart_write_finished_p ())
-        continue;
-
-    /* The IR receiver has a delay of about 150 microseconds.  So need
-       to wait for UART to have received the data and set its receive
-       complete bit.  */
-    DELAY_US (150);
-    
-    /* Check is something was inadvertently read.  */
-    if (ir_uart_read_ready_p ())
-        ir_uart_getc ();
 }
 
 
@@ -107,7 +109,8 @@ ir_uart_init (void)
     usart1_cfg_t usart1_cfg = 
         {
             .baud_divisor = USART1_BAUD_DIVISOR (IR_UART_BAUD_RATE),
-            .bits = 8
+            .bits = 8,
+            .echo_suppress = 1
         };
 
 
@@ -67,6 +67,23 @@ int8_t
 ir_uart_getc (void);
 
 
+/** Read up to size bytes received from IR_UART.  This does not block.
+    @param data buffer to fill
+    @param size maximum number of bytes to read
+    @return number of bytes read.  */
+uint8_t
+ir_uart_read (void *data, uint8_t size);
+
+
+/** Write up to size bytes to IR_UART.  This does not block; the bytes
+    are sent in the background and their echoes discarded.
+    @param data bytes to write
+    @param size number of bytes to write
+    @return number of bytes written.  */
+uint8_t
+ir_uart_write (const void *data, uint8_t size);
+
+
 /* Return non-zero if a character can be written without blocking.  */
 bool
 ir_uart_write_ready_p (void);
@@ -78,16 +95,15 @@ ir_uart_write_finished_p (void);
 
 
 /** Write character to IR_UART.  This blocks until the character can
-    be written into the transmit buffer.  It does not check to see
-    if there is any echoed character (see ir_uart_putc).  */
+    be written into the transmit buffer.  This is the same as
+    ir_uart_putc now that echoes are discarded on reception.  */
 void
 ir_uart_putc_nocheck (char ch);
 
 
-/* Write character to IR_UART.  This blocks until the character is
-   written.  It then checks if data has been received and if so, reads
-   the data and throws it away on the assumption that it is electrical
-   or optical echoing.  */
+/* Write character to IR_UART.  This blocks until the character can
+   be written into the transmit buffer.  Any echo of the character is
+   discarded when it is received.  */
 void
 ir_uart_putc (char ch);
 
@@ -4,6 +4,7 @@
     @brief  Timer module
 */
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include "timer.h"
 #include "system.h"
 
@@ -27,13 +28,49 @@
 #endif
 
 
+static volatile timer_tick_t timer_periodic_period;
+static volatile timer_callback_t timer_periodic_callback;
+
+
+/* Output compare A is moved on by the period each time it matches so
+   the calls stay in step with the free-running counter.  The function
+   is called first so that it can choose the period.  */
+ISR (TIMER1_COMPA_vect)
+{
+    timer_tick_t next;
+
+    timer_periodic_callback ();
+
+    next = OCR1A + timer_periodic_period;
+
+    /* If the function ran past the next match, the counter would have
+       to wrap around before it matched again.  */
+    if ((int16_t) (next - TCNT1) <= 0)
+        next = TCNT1 + 1;
+    OCR1A = next;
+}
+
+
 /** Initialise timer.  */
 void timer_init (void)
 {
+    uint8_t sreg;
+
+    sreg = SREG;
+    cli ();
+
     /* Start timer in normal mode so that it rolls over at 65535 to 0.  */
     TCCR1A = 0x00;
     TCCR1B = TCCR1B_INIT;
     TCNT1 = 0;
+
+    /* If timer_periodic_start has already run, its compare was set
+       against the old count and could now be up to a whole wrap away.
+       Set it again from the restarted count.  */
+    if (TIMSK1 & BIT (OCIE1A))
+        OCR1A = timer_periodic_period;
+
+    SREG = sreg;
 }
 
 
@@ -41,7 +78,19 @@ void timer_init (void)
     @return current time in ticks.  */
 timer_tick_t timer_get (void)
 {
-    return TCNT1;
+    timer_tick_t now;
+    uint8_t sreg;
+
+    /* The two bytes of TCNT1 are read through a temporary register
+       shared with the other 16-bit timer registers.  Block interrupts
+       so that an interrupt handler reading the timer between the two
+       byte reads cannot corrupt the result.  */
+    sreg = SREG;
+    cli ();
+    now = TCNT1;
+    SREG = sreg;
+
+    return now;
 }
 
 
@@ -72,6 +121,44 @@ timer_tick_t timer_wait_until (timer_tick_t when)
 }
 
 
+/** Call a function every period ticks from the timer compare
+    interrupt.
+    @param period ticks between calls
+    @param callback function to call.  */
+void timer_periodic_start (timer_tick_t period, timer_callback_t callback)
+{
+    cli ();
+    timer_periodic_period = period;
+    timer_periodic_callback = callback;
+    OCR1A = TCNT1 + period;
+
+    /* Clear any old match before enabling its interrupt.  */
+    TIFR1 = BIT (OCF1A);
+    TIMSK1 |= BIT (OCIE1A);
+    sei ();
+}
+
+
+/** Change the period of the periodic function.
+    @param period ticks between calls.  */
+void timer_periodic_period_set (timer_tick_t period)
+{
+    uint8_t sreg;
+
+    sreg = SREG;
+    cli ();
+    timer_periodic_period = period;
+    SREG = sreg;
+}
+
+
+/** Stop calling the periodic function.  */
+void timer_periodic_stop (void)
+{
+    TIMSK1 &= ~BIT (OCIE1A);
+}
+
+
 /** Wait for specified period:
     @param period how long to wait
     @return current time.  */
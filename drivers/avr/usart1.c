@@ -3,10 +3,51 @@
     @date   10 March 2005
 
     @brief Routines for interfacing with the usart1 on an Atmega32u2
+
+    Received bytes are stored in a ring buffer by the receive
+    interrupt and bytes to send are taken from a ring buffer by the
+    data register empty interrupt, so reading and writing never have
+    to wait for the line.  Each buffer has one writer and one reader
+    and the 8-bit indices are read and written atomically, so no
+    locking is needed.
 */
 #include "system.h"
 #include "usart1.h"
+#include "timer.h"
 #include <avr/io.h>
+#include <avr/interrupt.h>
+
+#define USART1_RX_MASK (USART1_RX_BUFFER_SIZE - 1)
+#define USART1_TX_MASK (USART1_TX_BUFFER_SIZE - 1)
+
+/* Number of recently sent bytes remembered for echo suppression.
+   At most two bytes are in the transmitter at once.  */
+#define USART1_ECHO_SIZE 4
+#define USART1_ECHO_MASK (USART1_ECHO_SIZE - 1)
+
+/* Bits per character including the start and stop bits.  */
+#define USART1_FRAME_BITS 10
+
+
+static volatile uint8_t rx_buffer[USART1_RX_BUFFER_SIZE];
+static volatile uint8_t rx_head;
+static volatile uint8_t rx_tail;
+
+static volatile uint8_t tx_buffer[USART1_TX_BUFFER_SIZE];
+static volatile uint8_t tx_head;
+static volatile uint8_t tx_tail;
+
+/* The bytes most recently loaded into the transmitter and when.
+   These are only used by the interrupt handlers.  */
+static uint8_t echo_data[USART1_ECHO_SIZE];
+static timer_tick_t echo_time[USART1_ECHO_SIZE];
+static uint8_t echo_head;
+static uint8_t echo_tail;
+
+/* How long after a byte is loaded that its echo can arrive; zero
+   disables echo suppression.  */
+static timer_tick_t echo_window;
+
 
 void
 usart1_baud_divisor_set (uint16_t divisor)
@@ -22,27 +63,130 @@ usart1_init (const usart1_cfg_t *cfg)
     uint8_t bits;
 
     usart1_baud_divisor_set (cfg->baud_divisor);
-    
+
     /* Default to 8 bits.  */
     bits = cfg->bits;
     if (bits < 5 || bits > 8)
         bits = 8;
 
-    /* Enable receiver and transmitter.  */
-    UCSR1B = BIT (RXEN1) | BIT (TXEN1);
+    rx_head = rx_tail = 0;
+    tx_head = tx_tail = 0;
+    echo_head = echo_tail = 0;
+
+    /* A byte loaded behind one already being shifted out finishes two
+       character times later; allow one more for the receiver delay
+       and for the echo to be received.  */
+    echo_window = 0;
+    if (cfg->echo_suppress)
+        echo_window = (uint32_t)3 * USART1_FRAME_BITS * 16 * cfg->baud_divisor
+            / TIMER_CLOCK_DIVISOR + 1;
+
+    /* Enable receiver, transmitter, and the receive interrupt.  The
+       data register empty interrupt is enabled when there is
+       something to send.  */
+    UCSR1B = BIT (RXEN1) | BIT (TXEN1) | BIT (RXCIE1);
 
     /* Set frame format: asynchronous USART, 1 stop bit, no parity.  */
     UCSR1C = ((bits - 5) << UCSZ10) | (0 << UPM10);
 
+    sei ();
+
     return 1;
 }
 
 
+/** Check a received byte against the bytes recently sent.
+    @param ch received byte
+    @return non-zero if the byte is an echo and should be discarded.  */
+static bool
+usart1_echo_p (uint8_t ch)
+{
+    timer_tick_t now;
+    uint8_t i;
+
+    now = timer_get ();
+
+    /* Forget bytes whose echo would have arrived by now.  */
+    while (echo_head != echo_tail
+           && (timer_tick_t)(now - echo_time[echo_head & USART1_ECHO_MASK])
+           >= echo_window)
+        echo_head++;
+
+    /* An echo may not have been received for every byte so look past
+       the oldest.  */
+    for (i = echo_head; i != echo_tail; i++)
+    {
+        if (echo_data[i & USART1_ECHO_MASK] == ch)
+        {
+            echo_head = i + 1;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+ISR (USART1_RX_vect)
+{
+    uint8_t status;
+    uint8_t ch;
+
+    /* The status must be read before the data register.  */
+    status = UCSR1A;
+    ch = UDR1;
+
+    /* Discard bytes with a bad stop bit; these are usually noise.  */
+    if (status & (BIT (FE1) | BIT (DOR1)))
+        return;
+
+    if (echo_window && usart1_echo_p (ch))
+        return;
+
+    /* Drop the byte if the buffer is full.  */
+    if ((uint8_t)(rx_tail - rx_head) >= USART1_RX_BUFFER_SIZE)
+        return;
+
+    rx_buffer[rx_tail & USART1_RX_MASK] = ch;
+    rx_tail++;
+}
+
+
+ISR (USART1_UDRE_vect)
+{
+    uint8_t ch;
+
+    if (tx_head == tx_tail)
+    {
+        /* Nothing left to send.  */
+        UCSR1B &= ~BIT (UDRIE1);
+        return;
+    }
+
+    ch = tx_buffer[tx_head & USART1_TX_MASK];
+    tx_head++;
+
+    if (echo_window)
+    {
+        if ((uint8_t)(echo_tail - echo_head) >= USART1_ECHO_SIZE)
+            echo_head++;
+        echo_data[echo_tail & USART1_ECHO_MASK] = ch;
+        echo_time[echo_tail & USART1_ECHO_MASK] = timer_get ();
+        echo_tail++;
+    }
+
+    /* Write a 1 to the TXC1 bit to clear it!  It will be set when the
+       data is shifted out of the transmit shift register.  */
+    UCSR1A |= BIT (TXC1);
+
+    UDR1 = ch;
+}
+
+
 /** Return non-zero if there is a character ready to be read.  */
 bool
 usart1_read_ready_p (void)
 {
-    return (UCSR1A & BIT (RXC1)) != 0;
+    return rx_head != rx_tail;
 }
 
 
@@ -50,32 +194,74 @@ usart1_read_ready_p (void)
 bool
 usart1_write_ready_p (void)
 {
-    return (UCSR1A & BIT (UDRE1)) != 0;
+    return (uint8_t)(tx_tail - tx_head) < USART1_TX_BUFFER_SIZE;
 }
 
 
-/** Return non-zero if transmission finished.  This is useful for
-    half-duplex operation.  */
+/** Return non-zero if the transmit buffer is empty and the last
+    character has been shifted out.  This is useful for half-duplex
+    operation.  */
 bool
 usart1_write_finished_p (void)
 {
-    return (UCSR1A & BIT (TXC1)) != 0;
+    return tx_head == tx_tail && (UCSR1A & BIT (TXC1)) != 0;
+}
+
+
+/** Read up to size bytes from the receive buffer.  This does not
+    block.
+    @param data buffer to fill
+    @param size maximum number of bytes to read
+    @return number of bytes read.  */
+uint8_t
+usart1_read (void *data, uint8_t size)
+{
+    uint8_t *dst = data;
+    uint8_t count;
+
+    for (count = 0; count < size && rx_head != rx_tail; count++)
+    {
+        dst[count] = rx_buffer[rx_head & USART1_RX_MASK];
+        rx_head++;
+    }
+    return count;
+}
+
+
+/** Write up to size bytes to the transmit buffer.  This does not
+    block; the bytes are sent by the transmit interrupt.
+    @param data bytes to write
+    @param size number of bytes to write
+    @return number of bytes written.  */
+uint8_t
+usart1_write (const void *data, uint8_t size)
+{
+    const uint8_t *src = data;
+    uint8_t count;
+
+    for (count = 0; count < size && usart1_write_ready_p (); count++)
+    {
+        tx_buffer[tx_tail & USART1_TX_MASK] = src[count];
+        tx_tail++;
+    }
+
+    /* The interrupt handler disables itself when the buffer empties.
+       If it does so between the read and write here, it is simply
+       re-enabled and disables itself again.  */
+    if (count)
+        UCSR1B |= BIT (UDRIE1);
+
+    return count;
 }
 
 
 /** Write character to USART1.  This blocks until the character can be
-    written into the transmit register.  */
+    written into the transmit buffer.  */
 void
 usart1_putc (char ch)
 {
-    while (!usart1_write_ready_p ())
-        continue;                   
-
-    /* Write a 1 to the TXC1 bit to clear it!  It will be set when the
-       data is shifted out of the transmit shift register.  */
-    UCSR1A |= BIT (TXC1);
-    
-    UDR1 = ch;
+    while (!usart1_write (&ch, 1))
+        continue;
 }
 
 
@@ -83,16 +269,18 @@ usart1_putc (char ch)
 int8_t
 usart1_getc (void)
 {
+    char ch;
+
     /* Wait for something in receive buffer.  */
-    while (!usart1_read_ready_p ())
+    while (!usart1_read (&ch, 1))
         continue;
 
-    return UDR1;
+    return ch;
 }
 
 
 /** Write string to USART1.  This blocks until the string is written.  */
-void 
+void
 usart1_puts (const char *str)
 {
     while (*str)
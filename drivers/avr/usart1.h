@@ -10,10 +10,36 @@
 
 #include "system.h"
 
+/** Size of the receive ring buffer.  This must be a power of two.  */
+#ifndef USART1_RX_BUFFER_SIZE
+#define USART1_RX_BUFFER_SIZE 16
+#endif
+
+/** Size of the transmit ring buffer.  This must be a power of two.  */
+#ifndef USART1_TX_BUFFER_SIZE
+#define USART1_TX_BUFFER_SIZE 16
+#endif
+
+#if (USART1_RX_BUFFER_SIZE & (USART1_RX_BUFFER_SIZE - 1)) \
+    || USART1_RX_BUFFER_SIZE > 128
+#error USART1_RX_BUFFER_SIZE must be a power of two no larger than 128
+#endif
+
+#if (USART1_TX_BUFFER_SIZE & (USART1_TX_BUFFER_SIZE - 1)) \
+    || USART1_TX_BUFFER_SIZE > 128
+#error USART1_TX_BUFFER_SIZE must be a power of two no larger than 128
+#endif
+
+
 typedef struct usart1_cfg_struct
 {
     uint16_t baud_divisor;
     uint8_t bits;
+    /* Non-zero to discard received bytes that match a byte sent
+       within the last three character times (half-duplex echo).
+       This times the echo with timer_get so the timer must be
+       running.  */
+    uint8_t echo_suppress;
 } usart1_cfg_t;
 
 
@@ -21,6 +47,24 @@ typedef struct usart1_cfg_struct
 #define USART1_BAUD_DIVISOR(BAUD_RATE)  ((F_CPU / 16) / (BAUD_RATE))
 
 
+/** Read up to size bytes from the receive buffer.  This does not
+    block.
+    @param data buffer to fill
+    @param size maximum number of bytes to read
+    @return number of bytes read.  */
+uint8_t
+usart1_read (void *data, uint8_t size);
+
+
+/** Write up to size bytes to the transmit buffer.  This does not
+    block; the bytes are sent by the transmit interrupt.
+    @param data bytes to write
+    @param size number of bytes to write
+    @return number of bytes written.  */
+uint8_t
+usart1_write (const void *data, uint8_t size);
+
+
 /** Return non-zero if there is a character ready to be read.  */
 bool
 usart1_read_ready_p (void);
@@ -37,14 +81,15 @@ bool
 usart1_write_ready_p (void);
 
 
-/** Return non-zero if transmission finished.  This is useful for
-    half-duplex operation.  */
+/** Return non-zero if the transmit buffer is empty and the last
+    character has been shifted out.  This is useful for half-duplex
+    operation.  */
 bool
 usart1_write_finished_p (void);
 
 
 /** Write character to USART1.  This blocks until the character can be
-    written into the transmit register.  */
+    written into the transmit buffer.  */
 void
 usart1_putc (char ch);
 
@@ -54,7 +99,8 @@ void
 usart1_puts (const char *str);
 
 
-/** Initialise usart1 and set baud rate.  */
+/** Initialise usart1 and set baud rate.  This enables the USART1
+    interrupts and global interrupts.  */
 uint8_t
 usart1_init (const usart1_cfg_t *cfg);
 
@@ -2,74 +2,470 @@
     @author M. P. Hayes, UCECE
     @date   23 August 2010
     @brief  Bit-mapped display driver.
+    @note   With more than one bit plane, the display is refreshed with
+            binary code modulation: each column shows plane 0 for one
+            time unit, plane 1 for two, and so on, so a pixel's
+            brightness is proportional to its level.  The cost is
+            DISPLAY_PLANES column writes per column however many
+            pixels are lit.
 */
 #include "system.h"
 #include "ledmat.h"
+#include "timer.h"
 #include "display.h"
 
-/** The state of the display (frame buffer).  */
-static uint8_t display[DISPLAY_WIDTH];
+/** Bit pattern with every row of a display column set.  */
+#define DISPLAY_COLUMN_MASK (BIT (DISPLAY_HEIGHT) - 1)
 
+/** A frame: a bit plane for each bit of the pixel levels, least
+    significant first.  */
+typedef uint8_t display_frame_t[DISPLAY_PLANES][DISPLAY_WIDTH];
 
-/** Set state of a display pixel.
+/** Frame buffers.  The refresh shows the front buffer.  */
+static display_frame_t display_buffers[2];
+static volatile uint8_t display_front;
+
+/** The frame buffer being drawn.  This is the front buffer unless
+    double buffering.  */
+static uint8_t (*display)[DISPLAY_WIDTH] = display_buffers[0];
+
+static bool display_double_buffer;
+static bool display_refreshing;
+
+/** Ticks for the shortest bit plane when refreshing in the
+    background.  */
+static timer_tick_t display_period;
+
+
+static void display_copy (display_frame_t dst, display_frame_t src)
+{
+    uint8_t plane;
+    uint8_t col;
+
+    for (plane = 0; plane < DISPLAY_PLANES; plane++)
+        for (col = 0; col < DISPLAY_WIDTH; col++)
+            dst[plane][col] = src[plane][col];
+}
+
+
+/** Set brightness of a display pixel.
     @param col pixel column
     @param row pixel row
-    @param val pixel state.  */
-void display_pixel_set (uint8_t col, uint8_t row, bool val)
+    @param level pixel brightness, 0 to DISPLAY_LEVEL_MAX.  */
+void display_pixel_level_set (uint8_t col, uint8_t row, uint8_t level)
 {
     uint8_t bitmask;
-    uint8_t pattern;
+    uint8_t plane;
 
     if (col >= DISPLAY_WIDTH || row >= DISPLAY_HEIGHT)
         return;
 
     bitmask = BIT (row);
-    pattern = display[col] & ~bitmask;
 
-    if (val)
-        pattern |= bitmask;
+    for (plane = 0; plane < DISPLAY_PLANES; plane++)
+    {
+        uint8_t pattern;
 
-    display[col] = pattern;
+        pattern = display[plane][col] & ~bitmask;
+        if (level & BIT (plane))
+            pattern |= bitmask;
+
+        display[plane][col] = pattern;
+    }
 }
 
 
-/** Get state of a display pixel.
+/** Get brightness of a display pixel.
     @param col pixel column
     @param row pixel row
-    @return pixel state or zero if outside display.  */
-bool display_pixel_get (uint8_t col, uint8_t row)
+    @return pixel brightness or zero if outside display.  */
+uint8_t display_pixel_level_get (uint8_t col, uint8_t row)
 {
     uint8_t bitmask;
+    uint8_t plane;
+    uint8_t level = 0;
 
     if (col >= DISPLAY_WIDTH || row >= DISPLAY_HEIGHT)
         return 0;
 
     bitmask = BIT (row);
 
-    return (display[col] & bitmask) != 0;
+    for (plane = 0; plane < DISPLAY_PLANES; plane++)
+    {
+        if (display[plane][col] & bitmask)
+            level |= BIT (plane);
+    }
+    return level;
 }
 
 
-/** Update display (perform refreshing).  */
-void display_update (void)
+/** Set state of a display pixel.
+    @param col pixel column
+    @param row pixel row
+    @param val pixel state.  */
+void display_pixel_set (uint8_t col, uint8_t row, bool val)
+{
+    display_pixel_level_set (col, row, val ? DISPLAY_LEVEL_MAX : 0);
+}
+
+
+/** Get state of a display pixel.
+    @param col pixel column
+    @param row pixel row
+    @return pixel state or zero if outside display.  */
+bool display_pixel_get (uint8_t col, uint8_t row)
+{
+    return display_pixel_level_get (col, row) != 0;
+}
+
+
+/** Set the pixels in a display column that are set in a pattern to
+    a brightness, leaving the others alone.
+    @param col pixel column
+    @param pattern column bit pattern, bit 0 is the top row
+    @param level pixel brightness, 0 to DISPLAY_LEVEL_MAX.  */
+void display_column_level_set (uint8_t col, uint8_t pattern, uint8_t level)
+{
+    uint8_t plane;
+
+    if (col >= DISPLAY_WIDTH)
+        return;
+
+    pattern &= DISPLAY_COLUMN_MASK;
+
+    for (plane = 0; plane < DISPLAY_PLANES; plane++)
+    {
+        if (level & BIT (plane))
+            display[plane][col] |= pattern;
+        else
+            display[plane][col] &= ~pattern;
+    }
+}
+
+
+/** Set the state of all the pixels in a display column.
+    @param col pixel column
+    @param pattern column bit pattern, bit 0 is the top row.  */
+void display_column_set (uint8_t col, uint8_t pattern)
+{
+    uint8_t plane;
+
+    if (col >= DISPLAY_WIDTH)
+        return;
+
+    for (plane = 0; plane < DISPLAY_PLANES; plane++)
+        display[plane][col] = pattern & DISPLAY_COLUMN_MASK;
+}
+
+
+/** Turn on the pixels in a display column that are set in a pattern.
+    @param col pixel column
+    @param pattern column bit pattern, bit 0 is the top row.  */
+void display_column_or (uint8_t col, uint8_t pattern)
+{
+    display_column_level_set (col, pattern, DISPLAY_LEVEL_MAX);
+}
+
+
+/** Turn off the pixels in a display column that are set in a pattern.
+    @param col pixel column
+    @param pattern column bit pattern, bit 0 is the top row.  */
+void display_column_andnot (uint8_t col, uint8_t pattern)
+{
+    display_column_level_set (col, pattern, 0);
+}
+
+
+/** Get the state of all the pixels in a display column.
+    @param col pixel column
+    @return column bit pattern of the pixels that are not off, or zero
+    if outside display.  */
+uint8_t display_column_get (uint8_t col)
+{
+    uint8_t plane;
+    uint8_t pattern = 0;
+
+    if (col >= DISPLAY_WIDTH)
+        return 0;
+
+    for (plane = 0; plane < DISPLAY_PLANES; plane++)
+        pattern |= display[plane][col];
+    return pattern;
+}
+
+
+/* Copy a bitmap to the columns of one bit plane.  */
+static void display_blit_columns (uint8_t *columns, int8_t col, int8_t row,
+                                  const uint8_t *bitmap,
+                                  uint8_t width, uint8_t height)
+{
+    uint8_t mask;
+    uint8_t first;
+    uint8_t i;
+
+    if (height > 8)
+        height = 8;
+
+    if (row <= -height || row >= DISPLAY_HEIGHT)
+        return;
+
+    /* Work out which display rows the bitmap covers; the shift is
+       the same for every column.  */
+    mask = BIT (height) - 1;
+    if (row < 0)
+        mask >>= -row;
+    else
+        mask <<= row;
+    mask &= DISPLAY_COLUMN_MASK;
+
+    /* Skip the columns to the left of the display.  */
+    first = col < 0 ? -col : 0;
+
+    for (i = first; i < width; i++)
+    {
+        uint8_t c;
+        uint8_t pattern;
+
+        c = col + i;
+        if (c >= DISPLAY_WIDTH)
+            break;
+
+        if (row < 0)
+            pattern = bitmap[i] >> -row;
+        else
+            pattern = bitmap[i] << row;
+
+        columns[c] = (columns[c] & ~mask) | (pattern & mask);
+    }
+}
+
+
+/** Copy a bitmap to the display.  Pixels within the bitmap's
+    rectangle are replaced; the parts that fall outside the display
+    are clipped.
+    @param col display column for the left of the bitmap
+    @param row display row for the top of the bitmap
+    @param bitmap column-major bitmap, one byte per column with bit 0
+    the top row
+    @param width number of columns in bitmap
+    @param height number of rows in bitmap (at most 8).  */
+void display_blit (int8_t col, int8_t row, const uint8_t *bitmap,
+                   uint8_t width, uint8_t height)
+{
+    uint8_t plane;
+
+    for (plane = 0; plane < DISPLAY_PLANES; plane++)
+        display_blit_columns (display[plane], col, row, bitmap, width, height);
+}
+
+
+/** Copy a bitmap to one bit plane of the display, as display_blit.
+    @param plane bit plane, 0 for the least significant bit of the
+    pixel levels
+    @param col display column for the left of the bitmap
+    @param row display row for the top of the bitmap
+    @param bitmap column-major bitmap, one byte per column with bit 0
+    the top row
+    @param width number of columns in bitmap
+    @param height number of rows in bitmap (at most 8).  */
+void display_plane_blit (uint8_t plane, int8_t col, int8_t row,
+                         const uint8_t *bitmap, uint8_t width, uint8_t height)
+{
+    if (plane >= DISPLAY_PLANES)
+        return;
+
+    display_blit_columns (display[plane], col, row, bitmap, width, height);
+}
+
+
+/** Replace the whole display with a frame of bit planes in one pass.
+    @param frame a column-major bitmap for each bit plane, plane 0
+    for the least significant bit of the pixel levels.  */
+void display_frame_set (const uint8_t frame[DISPLAY_PLANES][DISPLAY_WIDTH])
+{
+    uint8_t plane;
+    uint8_t col;
+
+    for (plane = 0; plane < DISPLAY_PLANES; plane++)
+    {
+        for (col = 0; col < DISPLAY_WIDTH; col++)
+            display[plane][col] = frame[plane][col] & DISPLAY_COLUMN_MASK;
+    }
+}
+
+
+/** Move the pixels in some rows of the display one column to the
+    left.  Column col is lost and the last column is set from a
+    pattern.
+    @param col leftmost column to change
+    @param mask rows to move, bit 0 is the top row
+    @param pattern pixels to turn on in the last column.  */
+void display_scroll_left (uint8_t col, uint8_t mask, uint8_t pattern)
+{
+    uint8_t plane;
+    uint8_t c;
+
+    mask &= DISPLAY_COLUMN_MASK;
+
+    for (plane = 0; plane < DISPLAY_PLANES; plane++)
+    {
+        uint8_t *columns = display[plane];
+
+        for (c = col; c < DISPLAY_WIDTH - 1; c++)
+            columns[c] = (columns[c] & ~mask) | (columns[c + 1] & mask);
+        if (col < DISPLAY_WIDTH)
+            columns[DISPLAY_WIDTH - 1] = (columns[DISPLAY_WIDTH - 1] & ~mask)
+                | (pattern & mask);
+    }
+}
+
+
+/** Move the pixels in some rows of the display down one row.  The
+    bottom row in the mask is lost and the top row in the mask is set
+    from a pattern.
+    @param col leftmost column to change
+    @param width number of columns to change
+    @param mask consecutive rows to move, bit 0 is the top row
+    @param pattern pixels to turn on in the top row, bit 0 for column
+    col.  */
+void display_scroll_down (uint8_t col, uint8_t width, uint8_t mask,
+                          uint8_t pattern)
+{
+    uint8_t plane;
+    uint8_t top;
+    uint8_t c;
+
+    mask &= DISPLAY_COLUMN_MASK;
+    top = mask & ~(mask << 1);
+
+    for (plane = 0; plane < DISPLAY_PLANES; plane++)
+    {
+        uint8_t *columns = display[plane];
+        uint8_t bits = pattern;
+
+        for (c = col; c < col + width && c < DISPLAY_WIDTH; c++)
+        {
+            columns[c] = (columns[c] & ~mask)
+                | ((columns[c] << 1) & mask & ~top) | (bits & 1 ? top : 0);
+            bits >>= 1;
+        }
+    }
+}
+
+
+/* Show the next bit plane or column of the front buffer.  This is
+   called from the timer interrupt when refreshing in the background.  */
+static void display_refresh (void)
 {
     static uint8_t col = 0;
+    static uint8_t plane = 0;
+    static uint8_t repeat = 0;
+
+    /* Without the interrupt the calls are evenly spaced, so a plane
+       is shown for longer by skipping calls.  */
+    if (repeat)
+    {
+        repeat--;
+        return;
+    }
+
+    ledmat_display_column (display_buffers[display_front][plane][col], col);
+
+    /* Plane p is shown for 2^p times as long as plane 0.  */
+    if (display_refreshing)
+        timer_periodic_period_set (display_period << plane);
+    else
+        repeat = BIT (plane) - 1;
+
+    plane++;
+    if (plane < DISPLAY_PLANES)
+        return;
+    plane = 0;
 
-    ledmat_display_column (display[col], col);
-    
     col++;
     if (col >= DISPLAY_WIDTH)
         col = 0;
 }
 
 
+/** Update display (perform refreshing).  This does nothing when the
+    display is refreshed in the background.  */
+void display_update (void)
+{
+    if (!display_refreshing)
+        display_refresh ();
+}
+
+
+/** Show what has been drawn since the last swap.  */
+void display_swap (void)
+{
+    uint8_t front;
+
+    if (!display_double_buffer)
+        return;
+
+    /* The refresh picks up the new front buffer from its next column.
+       A byte write cannot be split by an interrupt.  */
+    front = display_front ^ 1;
+    display_front = front;
+
+    /* Drawing carries on from the frame just shown.  */
+    display = display_buffers[front ^ 1];
+    display_copy (display, display_buffers[front]);
+}
+
+
+/** Draw to a back buffer that is only shown by display_swap.
+    @param enable non-zero to double buffer.  */
+void display_double_buffer_set (bool enable)
+{
+    uint8_t front = display_front;
+
+    display_double_buffer = enable;
+    if (enable)
+    {
+        display = display_buffers[front ^ 1];
+        display_copy (display, display_buffers[front]);
+    }
+    else
+    {
+        display = display_buffers[front];
+    }
+}
+
+
+/** Refresh the display from the timer interrupt.
+    @param rate column refresh rate in Hz.  */
+void display_refresh_start (uint16_t rate)
+{
+    /* A column takes 2^DISPLAY_PLANES - 1 units of time.  */
+    display_period = TIMER_RATE / ((uint32_t) rate * DISPLAY_LEVEL_MAX);
+    if (!display_period)
+        display_period = 1;
+
+    display_refreshing = 1;
+    timer_periodic_start (display_period, display_refresh);
+}
+
+
+/** Stop refreshing the display in the background.  */
+void display_refresh_stop (void)
+{
+    timer_periodic_stop ();
+    display_refreshing = 0;
+}
+
+
 /** Clear display.   */
 void display_clear (void)
 {
-    int col;
+    uint8_t plane;
+    uint8_t col;
 
-    for (col = 0; col < DISPLAY_WIDTH; col++)
-        display[col] = 0;
+    for (plane = 0; plane < DISPLAY_PLANES; plane++)
+        for (col = 0; col < DISPLAY_WIDTH; col++)
+            display[plane][col] = 0;
 }
 
 
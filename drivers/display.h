@@ -7,6 +7,24 @@
        
     This module implements a simple display frame-buffer.  It abstracts the
     multiplexing of a LED matrix display.
+
+    The display is refreshed a column at a time, either by calling
+    display_update at a steady rate or, after display_refresh_start,
+    from a timer interrupt so that it does not flicker when the
+    program is busy.  The refresh rate is then independent of how
+    often the program runs.
+
+    With double buffering, drawing goes to a back buffer and
+    display_swap shows it in one step, so a frame that is only partly
+    drawn is never seen.  The swap takes effect at the next column,
+    so one scan of the matrix may show columns of both frames.
+
+    Pixels have DISPLAY_PLANES bits of brightness, set by defining
+    DISPLAY_PLANES when compiling.  With 2 to 4 bit planes, the
+    display shows 4 to 16 levels of brightness using binary code
+    modulation; this needs the timer interrupt refresh, or
+    display_update called 2^DISPLAY_PLANES - 1 times as often.  The
+    on/off functions treat on as DISPLAY_LEVEL_MAX.
 */
 #ifndef DISPLAY_H
 #define DISPLAY_H
@@ -16,6 +34,18 @@
 #define DISPLAY_WIDTH LEDMAT_COLS_NUM
 #define DISPLAY_HEIGHT LEDMAT_ROWS_NUM
 
+/** Number of bits of brightness for each pixel.  */
+#ifndef DISPLAY_PLANES
+#define DISPLAY_PLANES 1
+#endif
+
+#if DISPLAY_PLANES < 1 || DISPLAY_PLANES > 4
+#error DISPLAY_PLANES must be 1 to 4
+#endif
+
+/** Brightness of a pixel that is fully on.  */
+#define DISPLAY_LEVEL_MAX (BIT (DISPLAY_PLANES) - 1)
+
 /** Set state of a display pixel.
     @param col pixel column (0 left)
     @param row pixel row (0 top)
@@ -30,10 +60,137 @@ void display_pixel_set (uint8_t col, uint8_t row, bool val);
 bool display_pixel_get (uint8_t col, uint8_t row);
 
 
-/** Update display (perform refreshing).  */
+/** Set brightness of a display pixel.
+    @param col pixel column (0 left)
+    @param row pixel row (0 top)
+    @param level pixel brightness, 0 to DISPLAY_LEVEL_MAX.  */
+void display_pixel_level_set (uint8_t col, uint8_t row, uint8_t level);
+
+
+/** Get brightness of a display pixel.
+    @param col pixel column (0 left)
+    @param row pixel row (0 top)
+    @return pixel brightness or zero if outside display.  */
+uint8_t display_pixel_level_get (uint8_t col, uint8_t row);
+
+
+/** Set the pixels in a display column that are set in a pattern to
+    a brightness, leaving the others alone.
+    @param col pixel column (0 left)
+    @param pattern column bit pattern, bit 0 is the top row
+    @param level pixel brightness, 0 to DISPLAY_LEVEL_MAX.  */
+void display_column_level_set (uint8_t col, uint8_t pattern, uint8_t level);
+
+
+/** Set the state of all the pixels in a display column.
+    @param col pixel column (0 left)
+    @param pattern column bit pattern, bit 0 is the top row.  */
+void display_column_set (uint8_t col, uint8_t pattern);
+
+
+/** Turn on the pixels in a display column that are set in a pattern.
+    @param col pixel column (0 left)
+    @param pattern column bit pattern, bit 0 is the top row.  */
+void display_column_or (uint8_t col, uint8_t pattern);
+
+
+/** Turn off the pixels in a display column that are set in a pattern.
+    @param col pixel column (0 left)
+    @param pattern column bit pattern, bit 0 is the top row.  */
+void display_column_andnot (uint8_t col, uint8_t pattern);
+
+
+/** Get the state of all the pixels in a display column.
+    @param col pixel column (0 left)
+    @return column bit pattern of the pixels that are not off, or zero
+    if outside display.  */
+uint8_t display_column_get (uint8_t col);
+
+
+/** Copy a bitmap to the display.  Pixels within the bitmap's
+    rectangle are replaced; the parts that fall outside the display
+    are clipped.
+    @param col display column for the left of the bitmap (may be negative)
+    @param row display row for the top of the bitmap (may be negative)
+    @param bitmap column-major bitmap, one byte per column with bit 0
+    the top row
+    @param width number of columns in bitmap
+    @param height number of rows in bitmap (at most 8).  */
+void display_blit (int8_t col, int8_t row, const uint8_t *bitmap,
+                   uint8_t width, uint8_t height);
+
+
+/** Copy a bitmap to one bit plane of the display, as display_blit.
+    A picture with several levels of brightness is drawn one plane at
+    a time.
+    @param plane bit plane, 0 for the least significant bit of the
+    pixel levels
+    @param col display column for the left of the bitmap (may be negative)
+    @param row display row for the top of the bitmap (may be negative)
+    @param bitmap column-major bitmap, one byte per column with bit 0
+    the top row
+    @param width number of columns in bitmap
+    @param height number of rows in bitmap (at most 8).  */
+void display_plane_blit (uint8_t plane, int8_t col, int8_t row,
+                         const uint8_t *bitmap, uint8_t width, uint8_t height);
+
+
+/** Replace the whole display with a frame of bit planes in one pass.
+    @param frame a column-major bitmap for each bit plane, plane 0
+    for the least significant bit of the pixel levels.  */
+void display_frame_set (const uint8_t frame[DISPLAY_PLANES][DISPLAY_WIDTH]);
+
+
+/** Move the pixels in some rows of the display one column to the
+    left.  Column col is lost and the last column is set from a
+    pattern.
+    @param col leftmost column to change
+    @param mask rows to move, bit 0 is the top row
+    @param pattern pixels to turn on in the last column.  */
+void display_scroll_left (uint8_t col, uint8_t mask, uint8_t pattern);
+
+
+/** Move the pixels in some rows of the display down one row.  The
+    bottom row in the mask is lost and the top row in the mask is set
+    from a pattern.
+    @param col leftmost column to change
+    @param width number of columns to change
+    @param mask consecutive rows to move, bit 0 is the top row
+    @param pattern pixels to turn on in the top row, bit 0 for column
+    col.  */
+void display_scroll_down (uint8_t col, uint8_t width, uint8_t mask,
+                          uint8_t pattern);
+
+
+/** Update display (perform refreshing).  This does nothing when the
+    display is refreshed in the background.  */
 void display_update (void);
 
 
+/** Show what has been drawn since the last swap.  The new back buffer
+    starts as a copy of the frame shown.  This does nothing unless
+    double buffering.  */
+void display_swap (void);
+
+
+/** Draw to a back buffer that is only shown by display_swap.
+    @param enable non-zero to double buffer.  */
+void display_double_buffer_set (bool enable);
+
+
+/** Refresh the display from the timer interrupt; display_update is
+    then not needed.  This enables interrupts.
+    @param rate column refresh rate in Hz; the whole display is
+    refreshed at rate / DISPLAY_WIDTH.  With bit planes, the shortest
+    plane is shown for TIMER_RATE / (rate * DISPLAY_LEVEL_MAX) ticks,
+    rounded down, so the rate is approximate.  */
+void display_refresh_start (uint16_t rate);
+
+
+/** Stop refreshing the display in the background.  */
+void display_refresh_stop (void);
+
+
 /** Clear display.   */
 void display_clear (void);
 
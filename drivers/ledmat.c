@@ -25,6 +25,67 @@ static const pio_t ledmat_cols[] =
 };
 
 
+/* If the rows are on consecutive bits of one port, they can all be
+   set with one write to the port register.  The pin map is checked
+   when compiling so the test is a constant and the unused path is
+   discarded.  Defining LEDMAT_ROWS_GENERIC forces the generic path.  */
+#if defined (PIO_DATA_) && LEDMAT_ROWS_NUM == 7 && !defined (LEDMAT_ROWS_GENERIC)
+
+/* PIO for row N if the rows are on successive bits of row 1's port,
+   going up or down.  */
+#define LEDMAT_ROW_UP_(N) \
+    ((LEDMAT_ROW1_PIO & 0xff) | ((PIO_BITMASK_ (LEDMAT_ROW1_PIO) << (N)) << 8))
+#define LEDMAT_ROW_DOWN_(N) \
+    ((LEDMAT_ROW1_PIO & 0xff) | ((PIO_BITMASK_ (LEDMAT_ROW1_PIO) >> (N)) << 8))
+
+#define LEDMAT_ROWS_UP_P \
+    (LEDMAT_ROW2_PIO == LEDMAT_ROW_UP_ (1) && LEDMAT_ROW3_PIO == LEDMAT_ROW_UP_ (2) \
+     && LEDMAT_ROW4_PIO == LEDMAT_ROW_UP_ (3) && LEDMAT_ROW5_PIO == LEDMAT_ROW_UP_ (4) \
+     && LEDMAT_ROW6_PIO == LEDMAT_ROW_UP_ (5) && LEDMAT_ROW7_PIO == LEDMAT_ROW_UP_ (6))
+
+#define LEDMAT_ROWS_DOWN_P \
+    (LEDMAT_ROW2_PIO == LEDMAT_ROW_DOWN_ (1) && LEDMAT_ROW3_PIO == LEDMAT_ROW_DOWN_ (2) \
+     && LEDMAT_ROW4_PIO == LEDMAT_ROW_DOWN_ (3) && LEDMAT_ROW5_PIO == LEDMAT_ROW_DOWN_ (4) \
+     && LEDMAT_ROW6_PIO == LEDMAT_ROW_DOWN_ (5) && LEDMAT_ROW7_PIO == LEDMAT_ROW_DOWN_ (6))
+
+#define LEDMAT_ROWS_PORT_P (LEDMAT_ROWS_UP_P || LEDMAT_ROWS_DOWN_P)
+
+
+/* Set all the rows with one write to their port.  */
+static inline void
+ledmat_rows_set (uint8_t pattern)
+{
+    uint8_t mask;
+    uint8_t bits;
+
+    if (LEDMAT_ROWS_UP_P)
+    {
+        /* Row 1 is the lowest bit; multiplying by a constant power of
+           2 is a shift.  */
+        mask = (uint8_t) (0x7f * PIO_BITMASK_ (LEDMAT_ROW1_PIO));
+        bits = pattern * PIO_BITMASK_ (LEDMAT_ROW1_PIO);
+    }
+    else
+    {
+        /* Row 1 is the highest bit so reverse the 7 bit pattern.  The
+           first step is a nibble swap, a single AVR instruction.  This
+           avoids a table, which would take RAM.  */
+        bits = (pattern << 4) | (pattern >> 4);
+        bits = ((bits & 0x33) << 2) | ((bits >> 2) & 0x33);
+        bits = ((bits & 0x55) << 1) | ((bits >> 1) & 0x55);
+        mask = (uint8_t) (0x7f * PIO_BITMASK_ (LEDMAT_ROW7_PIO));
+        bits = (bits >> 1) * PIO_BITMASK_ (LEDMAT_ROW7_PIO);
+    }
+
+    /* The rows are active low.  */
+    PIO_DATA_ (LEDMAT_ROW1_PIO)
+        = (PIO_DATA_ (LEDMAT_ROW1_PIO) & ~mask) | (~bits & mask);
+}
+#else
+#define LEDMAT_ROWS_PORT_P 0
+#endif
+
+
 /** Initialise PIO pins to drive LED matrix.  */
 void ledmat_init (void)
 {
@@ -59,15 +120,24 @@ void ledmat_display_column (uint8_t pattern, uint8_t col)
     pio_output_high (ledmat_cols[col_prev]);
 
     /* Activate desired rows based on desired pattern.  */
-    for (row = 0; row < LEDMAT_ROWS_NUM; row++)
+#ifdef LEDMAT_ROWS_UP_P
+    if (LEDMAT_ROWS_PORT_P)
     {
-        /* The rows are active low.  */
-        if (pattern & 1)
-            pio_output_low (ledmat_rows[row]);
-        else
-            pio_output_high (ledmat_rows[row]);
-
-        pattern >>= 1;
+        ledmat_rows_set (pattern);
+    }
+    else
+#endif
+    {
+        for (row = 0; row < LEDMAT_ROWS_NUM; row++)
+        {
+            /* The rows are active low.  */
+            if (pattern & 1)
+                pio_output_low (ledmat_rows[row]);
+            else
+                pio_output_high (ledmat_rows[row]);
+
+            pattern >>= 1;
+        }
     }
 
     /* Enable new column.  */
@@ -2,8 +2,8 @@
     @author M.P. Hayes
     @date   28 Aug 2008
     @brief Navswitch driver.
-    @note This polls the 5-way navigation switch
-          but does not do debouncing.
+    @note This polls the 5-way navigation switch, reading all the
+          switches on a port at once, and debounces them.
 */
 
 #include "system.h"
@@ -11,6 +11,13 @@
 #include "delay.h"
 #include "pio.h"
 
+#ifdef __AVR__
+#include <avr/interrupt.h>
+#endif
+
+
+#define NAVSWITCH_EVENT_QUEUE_MASK (NAVSWITCH_EVENT_QUEUE_SIZE - 1)
+
 
 /* Navswitch configuration structure.  */
 typedef struct
@@ -19,50 +26,63 @@ typedef struct
 } navswitch_cfg_t;
 
 
-/** Navswitch state structure.  */
+/* The switch pins on one port.  */
 typedef struct
 {
-    bool current;
-    bool previous;
-} navswitch_state_t;
+    pio_t pio;
+    uint8_t mask;
+} navswitch_port_t;
 
 
-/* Define navswitch PIO connections.  */    
+/* Define navswitch PIO connections.  */
 static const navswitch_cfg_t navswitch_cfg[] =
 {
     {NAVSWITCH_NORTH_PIO},
     {NAVSWITCH_EAST_PIO},
-    {NAVSWITCH_SOUTH_PIO}, 
+    {NAVSWITCH_SOUTH_PIO},
     {NAVSWITCH_WEST_PIO},
     {NAVSWITCH_PUSH_PIO}
 };
 
 #define NAVSWITCH_NUM ARRAY_SIZE (navswitch_cfg)
 
-static navswitch_state_t navswitch_state[NAVSWITCH_NUM];
+/* Ports with switch pins and the port used by each switch.  */
+static navswitch_port_t navswitch_ports[NAVSWITCH_NUM];
+static uint8_t navswitch_ports_num;
+static uint8_t navswitch_port[NAVSWITCH_NUM];
 
+/* Debounced state of each switch, one bit per switch, set when down.  */
+static uint8_t navswitch_current;
+static uint8_t navswitch_previous;
 
-/** Return true if navswitch state changed from up to down since 
+/* Integrator for each switch, counting up while the switch reads down
+   and down while it reads up.  */
+static uint8_t navswitch_count[NAVSWITCH_NUM];
+
+static navswitch_event_t navswitch_events[NAVSWITCH_EVENT_QUEUE_SIZE];
+static uint8_t navswitch_events_head;
+static uint8_t navswitch_events_tail;
+
+
+/** Return true if navswitch state changed from up to down since
     last call to navswitch_update
     @param  navswitch index of navswitch to select
     @return 1 if navswitch changed from up to down otherwise 0  */
 bool
 navswitch_push_event_p (uint8_t navswitch)
 {
-    return navswitch_state[navswitch].current
-        && !navswitch_state[navswitch].previous;
+    return (navswitch_current & ~navswitch_previous & BIT (navswitch)) != 0;
 }
 
 
-/** Return true if navswitch state changed from down to up since 
+/** Return true if navswitch state changed from down to up since
     last call to navswitch_update
     @param  navswitch index of navswitch to select
     @return 1 if navswitch changed from down to up otherwise 0  */
 bool
 navswitch_release_event_p (uint8_t navswitch)
 {
-    return !navswitch_state[navswitch].current 
-        && navswitch_state[navswitch].previous;
+    return (~navswitch_current & navswitch_previous & BIT (navswitch)) != 0;
 }
 
 
@@ -72,7 +92,7 @@ navswitch_release_event_p (uint8_t navswitch)
 bool
 navswitch_down_p (uint8_t navswitch)
 {
-    return navswitch_state[navswitch].current;
+    return (navswitch_current & BIT (navswitch)) != 0;
 }
 
 
@@ -82,57 +102,202 @@ navswitch_down_p (uint8_t navswitch)
 bool
 navswitch_up_p (uint8_t navswitch)
 {
-    return !navswitch_state[navswitch].current;
+    return !navswitch_down_p (navswitch);
 }
 
 
-/** Poll all the navswitches and update their state.  */
-void
-navswitch_update (void)
+/** Get the oldest push or release event.
+    @param  event pointer to where to store the event
+    @return 1 if there was an event otherwise 0  */
+bool
+navswitch_event_get (navswitch_event_t *event)
+{
+    if (navswitch_events_head == navswitch_events_tail)
+        return 0;
+
+    *event = navswitch_events[navswitch_events_head
+                              & NAVSWITCH_EVENT_QUEUE_MASK];
+    navswitch_events_head++;
+    return 1;
+}
+
+
+/* Queue an event, dropping it if the queue is full.  */
+static void
+navswitch_event_add (uint8_t navswitch, bool pushed, timer_tick_t time)
+{
+    navswitch_event_t *event;
+
+    if ((uint8_t)(navswitch_events_tail - navswitch_events_head)
+        >= NAVSWITCH_EVENT_QUEUE_SIZE)
+        return;
+
+    event = &navswitch_events[navswitch_events_tail
+                              & NAVSWITCH_EVENT_QUEUE_MASK];
+    event->time = time;
+    event->navswitch = navswitch;
+    event->pushed = pushed;
+    navswitch_events_tail++;
+}
+
+
+/* Group the switch pins by port.  */
+static void
+navswitch_ports_init (void)
+{
+    uint8_t i;
+    uint8_t j;
+
+    for (i = 0; i < NAVSWITCH_NUM; i++)
+    {
+        pio_t pio = navswitch_cfg[i].pio;
+
+        for (j = 0; j < navswitch_ports_num; j++)
+        {
+            if (PIO_PORT_ (navswitch_ports[j].pio) == PIO_PORT_ (pio))
+                break;
+        }
+        if (j == navswitch_ports_num)
+        {
+            navswitch_ports[j].pio = pio;
+            navswitch_ports[j].mask = 0;
+            navswitch_ports_num++;
+        }
+        navswitch_ports[j].mask |= PIO_BITMASK_ (pio);
+        navswitch_port[i] = j;
+    }
+}
+
+
+/* Read the switches, returning a bit for each switch that is down.  */
+static uint8_t
+navswitch_sample (void)
 {
+    uint8_t ddr[NAVSWITCH_NUM];
+    uint8_t data[NAVSWITCH_NUM];
+    uint8_t pins[NAVSWITCH_NUM];
+    uint8_t down = 0;
     uint8_t i;
+#ifdef __AVR__
+    uint8_t sreg;
+#endif
 
     /* The switch is a 5-way navigation switch with push.  The common
        connection is connected to ground.  The 5 switch outputs share
        the LED matrix display column drive pins so we need to save the
        state of the column outputs, switch them to inputs, read the
        switch states, switch them back to outputs, and restore the
-       output state.
+       output state.  The pins are changed a port at a time so that
+       all the switches are read after one delay.
 
        When a switch is pushed it will pull its associated PIO pin low
        via a 2.2 kohm resistor.  When the PIO pin is configured as an
        input with pullup, pushing the switch will also turn on the
        column MOSFET driver.  This will cause some ghosting of the
        display.  This can be avoided by driving all the LED matrix
-       rows low while we read the switches.  */
+       rows low while we read the switches.
 
-    for (i = 0; i < NAVSWITCH_NUM; i++)
+       The display may be refreshed from an interrupt, which drives
+       the same pins, so interrupts are blocked while sampling.  */
+
+#ifdef __AVR__
+    sreg = SREG;
+    cli ();
+#endif
+
+    for (i = 0; i < navswitch_ports_num; i++)
     {
-        pio_config_t config;
+        pio_t pio = navswitch_ports[i].pio;
+        uint8_t mask = navswitch_ports[i].mask;
 
-        navswitch_state[i].previous = navswitch_state[i].current;
-    
-        config = pio_config_get (navswitch_cfg[i].pio);
+        ddr[i] = PIO_DDR_ (pio);
+        data[i] = PIO_DATA_ (pio);
 
-        /* Momentarily force PIO pin high to charge gate capacitance of
-           MOSFET otherwise will always read logic low and think the
+        /* Momentarily force the pins high to charge gate capacitance
+           of MOSFET otherwise will always read logic low and think the
            switch is pushed.  Alternatively, we need to wait 10 us or
            more so that the gate capacitance of the MOSFET charges via
            the internal pullup resistor.  */
-        pio_config_set (navswitch_cfg[i].pio, PIO_OUTPUT_HIGH);
+        PIO_DATA_ (pio) |= mask;
+        PIO_DDR_ (pio) |= mask;
 
-        /* Switch PIO to an input to read switch.  */
-        pio_config_set (navswitch_cfg[i].pio, PIO_PULLUP);
+        /* Switch the pins to inputs with pullup to read the switches.  */
+        PIO_DDR_ (pio) &= ~mask;
+    }
 
-        /* Wait long enough for MOSFET gate capacitance to discharge
-           through 2.2 kohm resistor when switch is pushed (connected
-           to ground).  */
-        DELAY_US (2.5); 
+    /* Wait long enough for MOSFET gate capacitance to discharge
+       through 2.2 kohm resistor when switch is pushed (connected
+       to ground).  */
+    DELAY_US (2.5);
 
-        navswitch_state[i].current = pio_input_get (navswitch_cfg[i].pio) == 0;
+    for (i = 0; i < navswitch_ports_num; i++)
+        pins[i] = PIO_PIN_ (navswitch_ports[i].pio);
 
-        /* Restore PIO state.  */
-        pio_config_set (navswitch_cfg[i].pio, config);
+    /* Restore the pins, leaving the rest of each port alone.  */
+    for (i = 0; i < navswitch_ports_num; i++)
+    {
+        pio_t pio = navswitch_ports[i].pio;
+        uint8_t mask = navswitch_ports[i].mask;
+
+        PIO_DATA_ (pio) = (PIO_DATA_ (pio) & ~mask) | (data[i] & mask);
+        PIO_DDR_ (pio) = (PIO_DDR_ (pio) & ~mask) | (ddr[i] & mask);
+    }
+
+#ifdef __AVR__
+    SREG = sreg;
+#endif
+
+    for (i = 0; i < NAVSWITCH_NUM; i++)
+    {
+        if (!(pins[navswitch_port[i]] & PIO_BITMASK_ (navswitch_cfg[i].pio)))
+            down |= BIT (i);
+    }
+    return down;
+}
+
+
+/** Poll all the navswitches and update their state.  */
+void
+navswitch_update (void)
+{
+    uint8_t down;
+    uint8_t i;
+    timer_tick_t now;
+
+    if (!navswitch_ports_num)
+        navswitch_ports_init ();
+
+    down = navswitch_sample ();
+    now = timer_get ();
+
+    navswitch_previous = navswitch_current;
+
+    /* A switch only changes state once its integrator reaches a limit,
+       so a bounce or glitch shorter than NAVSWITCH_INTEGRATOR_MAX
+       samples is ignored.  */
+    for (i = 0; i < NAVSWITCH_NUM; i++)
+    {
+        if (down & BIT (i))
+        {
+            if (navswitch_count[i] < NAVSWITCH_INTEGRATOR_MAX)
+                navswitch_count[i]++;
+            if (navswitch_count[i] == NAVSWITCH_INTEGRATOR_MAX
+                && !(navswitch_current & BIT (i)))
+            {
+                navswitch_current |= BIT (i);
+                navswitch_event_add (i, 1, now);
+            }
+        }
+        else
+        {
+            if (navswitch_count[i])
+                navswitch_count[i]--;
+            if (!navswitch_count[i] && (navswitch_current & BIT (i)))
+            {
+                navswitch_current &= ~BIT (i);
+                navswitch_event_add (i, 0, now);
+            }
+        }
     }
 }
 
@@ -140,5 +305,6 @@ navswitch_update (void)
 /** Initialise navswitch driver.  */
 void navswitch_init (void)
 {
-    /* Nothing to do since we configure PIOs when polling the switch.  */
+    /* The PIOs are configured when polling the switch.  */
+    navswitch_ports_init ();
 }
@@ -1,12 +1,16 @@
 /**  @file   navswitch.h
      @author M. P. Hayes, UCECE
      @date   15 Feb 2003
-     @brief  Navswitch polling (no debouncing).
+     @brief  Navswitch polling with debouncing.
 
      @defgroup navswitch Navswitch driver
        
-     This module implements a simple navswitch driver.  Note, no
-     debouncing is performed.
+     This module implements a simple navswitch driver.  A switch
+     changes state once it has read the same for about
+     NAVSWITCH_INTEGRATOR_MAX calls of navswitch_update, so bounces
+     are ignored.  Each change is also queued with the time it was
+     seen, so a program that checks the switch less often than it is
+     polled does not miss presses.
 
      Here's an example application where the navswitches are polled at 50 Hz:
 
@@ -33,6 +37,18 @@
         }
     }
     @endcode
+
+    The queued events can be used instead of navswitch_push_event_p:
+
+    @code
+        navswitch_event_t event;
+
+        while (navswitch_event_get (&event))
+        {
+            if (event.pushed && event.navswitch == NAVSWITCH_EAST)
+                // Do something
+        }
+    @endcode
 */
 
 
@@ -40,12 +56,38 @@
 #define NAVSWITCH_H
 
 #include "system.h"
+#include "timer.h"
+
+
+/** Number of consecutive samples needed to change a switch state.  */
+#ifndef NAVSWITCH_INTEGRATOR_MAX
+#define NAVSWITCH_INTEGRATOR_MAX 2
+#endif
+
+/** Number of events that can be queued.  This must be a power of 2.  */
+#ifndef NAVSWITCH_EVENT_QUEUE_SIZE
+#define NAVSWITCH_EVENT_QUEUE_SIZE 8
+#endif
+
+#if NAVSWITCH_EVENT_QUEUE_SIZE & (NAVSWITCH_EVENT_QUEUE_SIZE - 1)
+#error NAVSWITCH_EVENT_QUEUE_SIZE must be a power of 2
+#endif
 
 
 enum {NAVSWITCH_NORTH, NAVSWITCH_EAST, NAVSWITCH_SOUTH, NAVSWITCH_WEST, 
       NAVSWITCH_PUSH};
 
 
+/** A switch being pushed or released.  */
+typedef struct
+{
+    /* Time of the navswitch_update that saw the change.  */
+    timer_tick_t time;
+    uint8_t navswitch;
+    bool pushed;
+} navswitch_event_t;
+
+
 /** Poll all the navswitches and update their state.  */
 void navswitch_update (void);
 
@@ -76,6 +118,13 @@ bool navswitch_down_p (uint8_t navswitch);
 bool navswitch_up_p (uint8_t navswitch);
 
 
+/** Get the oldest push or release event.  Events are queued by
+    navswitch_update; if the queue is full new events are dropped.
+    @param  event pointer to where to store the event
+    @return 1 if there was an event otherwise 0  */
+bool navswitch_event_get (navswitch_event_t *event);
+
+
 /** Initialise navswitch driver.  */
 void navswitch_init (void);
 #endif
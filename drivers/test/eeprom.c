@@ -1,50 +1,243 @@
 /** @file   eeprom.c
     @author M. P. Hayes, UCECE
     @date   15 May 2007
-    @brief 
+    @brief  EEPROM emulation backed by a file.
+
+    The EEPROM contents are kept in ucfk_eeprom.dat, which is mapped
+    into memory on first use so that reads and writes are plain memory
+    accesses.  Each byte written is counted in ucfk_eeprom.wear, which
+    accumulates over runs like the wear of a real part.  At exit a
+    report shows the writes made by the run and how close the most
+    worn cell is to the endurance of the ATmega32u2 EEPROM.
+
+    Asynchronous writes are queued as on the AVR and each takes
+    EEPROM_WRITE_NS to complete, measured in real time.  The queue is
+    advanced whenever the EEPROM is used.  As on the AVR, a queued
+    byte is compared with its cell only when its turn comes, and a
+    read of a byte that is not queued waits for the write in progress.
+    Synchronous writes do not wait.
 */
 #include "system.h"
 #include "eeprom.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 
-#define EEPROM_SIZE 512
+#define EEPROM_SIZE 1024
 #define EEPROM_FILENAME "ucfk_eeprom.dat"
+#define EEPROM_WEAR_FILENAME "ucfk_eeprom.wear"
+
+/* Erase/write cycles each cell is rated for.  */
+#define EEPROM_ENDURANCE 100000
+
+/* Time to erase and write a byte.  */
+#define EEPROM_WRITE_NS 3400000
+
+#define EEPROM_QUEUE_MASK (EEPROM_QUEUE_SIZE - 1)
+
+
+typedef struct
+{
+    eeprom_addr_t addr;
+    uint8_t data;
+} eeprom_queue_t;
+
+
+static uint8_t *eeprom;
+
+/* Writes to each cell over all runs and in this run.  */
+static uint32_t *eeprom_wear;
+static uint32_t eeprom_run_writes[EEPROM_SIZE];
+
+static struct timespec eeprom_start;
+
+/* Writes that have not started yet.  */
+static eeprom_queue_t queue[EEPROM_QUEUE_SIZE];
+static uint8_t queue_head;
+static uint8_t queue_tail;
+
+/* When the write in progress finishes.  */
+static uint64_t eeprom_busy_until;
+
+
+static uint64_t
+eeprom_now (void)
+{
+    struct timespec time;
+
+    clock_gettime (CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+
+/* Map a file of SIZE bytes, filling it with FILL if it is new or
+   short.  Fall back to memory that is lost at exit if the file
+   cannot be mapped.  */
+static void *
+eeprom_file_map (const char *filename, size_t size, uint8_t fill)
+{
+    void *map;
+    off_t length;
+    int fd;
+
+    fd = open (filename, O_RDWR | O_CREAT, 0644);
+    if (fd >= 0)
+    {
+        length = lseek (fd, 0, SEEK_END);
+        if (length >= 0 && (size_t) length < size)
+        {
+            uint8_t buffer[EEPROM_SIZE * sizeof (uint32_t)];
+
+            memset (buffer, fill, size - length);
+            if (write (fd, buffer, size - length) != (ssize_t) (size - length))
+                length = -1;
+        }
+
+        map = MAP_FAILED;
+        if (length >= 0)
+            map = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close (fd);
+        if (map != MAP_FAILED)
+            return map;
+    }
+
+    perror (filename);
+    map = malloc (size);
+    memset (map, fill, size);
+    return map;
+}
 
 
 static void
-eeprom_file_write (void *buffer, eeprom_size_t size)
+eeprom_report (void)
 {
-    FILE *fp;
+    struct timespec now;
+    double seconds;
+    unsigned long total = 0;
+    unsigned int cells = 0;
+    unsigned int worn = 0;
+    eeprom_addr_t hottest = 0;
+    eeprom_addr_t addr;
 
-    fp = fopen (EEPROM_FILENAME, "w");
-    if (fp)
+    for (addr = 0; addr < EEPROM_SIZE; addr++)
     {
-        fwrite (buffer, size, 1, fp);
-        fclose (fp);
+        total += eeprom_run_writes[addr];
+        if (eeprom_run_writes[addr])
+            cells++;
+        if (eeprom_wear[addr] >= EEPROM_ENDURANCE)
+            worn++;
+        if (eeprom_wear[addr] > eeprom_wear[hottest])
+            hottest = addr;
+    }
+
+    fprintf (stderr, "eeprom: %lu bytes written to %u cells this run\n",
+             total, cells);
+    fprintf (stderr, "eeprom: most worn cell %u has %lu writes, %.1f%% of %u\n",
+             hottest, (unsigned long) eeprom_wear[hottest],
+             eeprom_wear[hottest] * 100.0 / EEPROM_ENDURANCE, EEPROM_ENDURANCE);
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    seconds = (now.tv_sec - eeprom_start.tv_sec)
+        + (now.tv_nsec - eeprom_start.tv_nsec) * 1e-9;
+    if (eeprom_run_writes[hottest] && seconds > 0
+        && eeprom_wear[hottest] < EEPROM_ENDURANCE)
+    {
+        double left;
+
+        left = (EEPROM_ENDURANCE - eeprom_wear[hottest])
+            / (eeprom_run_writes[hottest] / seconds);
+        if (left < 3600)
+            fprintf (stderr, "eeprom: at this run's rate it wears out in %.1f s\n",
+                     left);
+        else
+            fprintf (stderr, "eeprom: at this run's rate it wears out in %.0f hours\n",
+                     left / 3600);
     }
+    if (worn)
+        fprintf (stderr, "eeprom: %u cells are past their endurance\n", worn);
+}
+
+
+static void
+eeprom_init (void)
+{
+    if (eeprom)
+        return;
+
+    /* If file not present assume EEPROM is erased and thus
+       contains the values 0xff.  */
+    eeprom = eeprom_file_map (EEPROM_FILENAME, EEPROM_SIZE, 0xff);
+    eeprom_wear = eeprom_file_map (EEPROM_WEAR_FILENAME,
+                                   EEPROM_SIZE * sizeof (*eeprom_wear), 0);
+
+    clock_gettime (CLOCK_MONOTONIC, &eeprom_start);
+    atexit (eeprom_report);
+}
+
+
+/* Erase and write one cell.  */
+static void
+eeprom_cell_write (eeprom_addr_t addr, uint8_t data)
+{
+    eeprom_wear[addr]++;
+    eeprom_run_writes[addr]++;
+    eeprom[addr] = data;
 }
 
 
+/* Start the queued writes whose turn has come.  A byte that is
+   already in its cell takes no time, as with the ready interrupt.  */
 static void
-eeprom_file_read (void *buffer, eeprom_size_t size)
+eeprom_queue_update (void)
 {
-    FILE *fp;
+    uint64_t now;
 
-    fp = fopen (EEPROM_FILENAME, "r");
-    if (!fp)
+    now = eeprom_now ();
+    while (queue_head != queue_tail && eeprom_busy_until <= now)
     {
-        /* If file not present assume EEPROM is erased and thus
-           contains the values 0xff.  */
-        memset (buffer, 0xff, size);
-        eeprom_file_write (buffer, size);
+        eeprom_queue_t *entry = &queue[queue_head & EEPROM_QUEUE_MASK];
+
+        queue_head++;
+        if (eeprom[entry->addr] == entry->data)
+            continue;
+
+        eeprom_cell_write (entry->addr, entry->data);
+        eeprom_busy_until += EEPROM_WRITE_NS;
     }
-    else
+}
+
+
+/* Wait for the write in progress to finish, as a read must.  */
+static void
+eeprom_idle_wait (void)
+{
+    uint64_t now;
+
+    now = eeprom_now ();
+    if (eeprom_busy_until > now)
+        usleep ((eeprom_busy_until - now) / 1000 + 1);
+}
+
+
+/* Find the newest queued write to ADDR.
+   Return its index or -1 if there is none.  */
+static int
+eeprom_queue_find (eeprom_addr_t addr)
+{
+    uint8_t i;
+
+    for (i = queue_tail; i != queue_head; )
     {
-        fread (buffer, size, 1, fp);
-        fclose (fp);
+        i--;
+        if (queue[i & EEPROM_QUEUE_MASK].addr == addr)
+            return i & EEPROM_QUEUE_MASK;
     }
+    return -1;
 }
 
 
@@ -54,32 +247,118 @@ eeprom_read (eeprom_addr_t addr, void *buffer, eeprom_size_t size)
 {
     eeprom_size_t i;
     uint8_t *data = buffer;
-    uint8_t eeprom[EEPROM_SIZE];
+    bool waited = 0;
 
-    eeprom_file_read (eeprom, EEPROM_SIZE);
+    eeprom_init ();
+    eeprom_queue_update ();
 
+    /* No queued write starts until the read is done.  */
     for (i = 0; i < size && addr < EEPROM_SIZE; i++)
-        data[i] = eeprom[addr++];
+    {
+        int pending;
 
-    return i;
+        pending = eeprom_queue_find (addr);
+        if (pending >= 0)
+            data[i] = queue[pending].data;
+        else
+        {
+            if (!waited)
+            {
+                eeprom_idle_wait ();
+                waited = 1;
+            }
+            data[i] = eeprom[addr];
+        }
+        addr++;
+    }
 
+    return i;
 }
 
 
 /* Write SIZE bytes to ADDR from BUFFER.  */
-eeprom_size_t 
+eeprom_size_t
 eeprom_write (eeprom_addr_t addr, const void *buffer, eeprom_size_t size)
 {
     eeprom_size_t i;
     const uint8_t *data = buffer;
-    uint8_t eeprom[EEPROM_SIZE];
 
-    eeprom_file_read (eeprom, EEPROM_SIZE);
+    eeprom_init ();
+
+    /* Keep the order of writes to the same address.  */
+    eeprom_flush ();
 
+    /* Each byte is erased and written even if it does not change.  */
     for (i = 0; i < size && addr < EEPROM_SIZE; i++)
-        eeprom[addr++] = data[i];
+        eeprom_cell_write (addr++, data[i]);
+
+    return i;
+}
 
-    eeprom_file_write (eeprom, EEPROM_SIZE);
+
+/** Queue SIZE bytes from BUFFER to be written to ADDR without
+    waiting.
+    @return number of bytes accepted.  */
+eeprom_size_t
+eeprom_write_async (eeprom_addr_t addr, const void *buffer, eeprom_size_t size)
+{
+    eeprom_size_t i;
+    const uint8_t *data = buffer;
+    uint64_t now;
+
+    eeprom_init ();
+    eeprom_queue_update ();
+
+    for (i = 0; i < size && addr < EEPROM_SIZE; i++, addr++)
+    {
+        int pending;
+
+        /* Replace a write that has not started yet.  */
+        pending = eeprom_queue_find (addr);
+        if (pending >= 0)
+        {
+            queue[pending].data = data[i];
+            continue;
+        }
+
+        if ((uint8_t)(queue_tail - queue_head) >= EEPROM_QUEUE_SIZE)
+            break;
+
+        /* Start at once if idle, as the ready interrupt would.  */
+        now = eeprom_now ();
+        if (queue_head == queue_tail && eeprom_busy_until <= now)
+        {
+            if (eeprom[addr] != data[i])
+            {
+                eeprom_cell_write (addr, data[i]);
+                eeprom_busy_until = now + EEPROM_WRITE_NS;
+            }
+            continue;
+        }
+
+        queue[queue_tail & EEPROM_QUEUE_MASK].addr = addr;
+        queue[queue_tail & EEPROM_QUEUE_MASK].data = data[i];
+        queue_tail++;
+    }
 
     return i;
 }
+
+
+/** Return non-zero when all queued writes have finished.  */
+bool
+eeprom_write_done_p (void)
+{
+    eeprom_queue_update ();
+
+    return queue_head == queue_tail && eeprom_busy_until <= eeprom_now ();
+}
+
+
+/** Wait for all queued writes to finish.  */
+void
+eeprom_flush (void)
+{
+    while (!eeprom_write_done_p ())
+        eeprom_idle_wait ();
+}
@@ -18,13 +18,53 @@
 typedef uint16_t eeprom_addr_t;
 typedef uint16_t eeprom_size_t;
 
-/* Read SIZE bytes from ADDR into BUFFER.  */
+/** Number of bytes that can wait to be written by
+    eeprom_write_async.  This must be a power of 2.  */
+#ifndef EEPROM_QUEUE_SIZE
+#define EEPROM_QUEUE_SIZE 16
+#endif
+
+#if EEPROM_QUEUE_SIZE & (EEPROM_QUEUE_SIZE - 1)
+#error EEPROM_QUEUE_SIZE must be a power of 2
+#endif
+
+
+/* Read SIZE bytes from ADDR into BUFFER.  Bytes still waiting to be
+   written by eeprom_write_async are read as their new values.  Other
+   bytes wait for the write in progress, if any, to finish, but no
+   further queued write starts until the read is done.  */
 extern eeprom_size_t
 eeprom_read (eeprom_addr_t addr, void *buffer, eeprom_size_t size);
 
 
-/* Write SIZE bytes to ADDR from BUFFER.  */
+/* Write SIZE bytes to ADDR from BUFFER.  This waits for any
+   asynchronous writes to finish and then for each byte to be
+   written, about 3.3 ms per byte.  */
 extern eeprom_size_t 
 eeprom_write (eeprom_addr_t addr, const void *buffer, eeprom_size_t size);
 
+
+/** Queue SIZE bytes from BUFFER to be written to ADDR without
+    waiting.  The bytes are written in the background, one every
+    3.3 ms or so, by the EEPROM ready interrupt, which is enabled
+    along with global interrupts.  Queueing does not read the EEPROM,
+    so it never waits for a write.  Each byte is compared with its
+    cell when its turn comes and skipped if it already holds the
+    value, and a byte queued again before it is written is only
+    written once.
+    @return number of bytes accepted; this is less than SIZE if the
+    queue fills, in which case the rest can be written later.  */
+extern eeprom_size_t
+eeprom_write_async (eeprom_addr_t addr, const void *buffer, eeprom_size_t size);
+
+
+/** Return non-zero when all queued writes have finished.  */
+extern bool
+eeprom_write_done_p (void);
+
+
+/** Wait for all queued writes to finish.  */
+extern void
+eeprom_flush (void);
+
 #endif
@@ -1,17 +1,265 @@
 /** @file   ir_uart.c
     @author M. P. Hayes, UCECE
     @date   1 Aug 2011
-    @brief  This is just a stub that does nothing.
-*/
+    @brief  Host IR UART that links two test programs through a socket.
+
+    If the environment variable IR_UART_SOCKET names a path, the first
+    program to start listens on a UNIX-domain socket at that path and
+    the second connects to it.  Each byte written is sent with the time
+    its last bit would leave a 2400 baud transmitter, and the receiver
+    only sees the byte after then, so both programs must run on the
+    same machine.  Without IR_UART_SOCKET, written bytes are dropped
+    and nothing is received.
+
+    These environment variables change the link:
+
+    IR_UART_ECHO     non-zero to receive our own bytes as the IR
+                     receiver does on the real board
+    IR_UART_LOSS     probability that a byte is lost
+    IR_UART_CORRUPT  probability that each bit of a byte is flipped
+    IR_UART_SEED     seed for the loss and corruption.  */
 #include "system.h"
 #include "ir_uart.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+/* Bits per character including the start and stop bits.  */
+#define IR_UART_FRAME_BITS 10
+
+#define IR_UART_CHAR_NS (IR_UART_FRAME_BITS * 1000000000ULL / IR_UART_BAUD_RATE)
+
+/* Transmit buffer size, as for USART1.  */
+#define IR_UART_TX_BUFFER_SIZE 16
+
+/* Bytes sent but not yet read.  This must be a power of 2.  */
+#define IR_UART_RX_BUFFER_SIZE 64
+#define IR_UART_RX_MASK (IR_UART_RX_BUFFER_SIZE - 1)
+
+/* A byte on the socket: 8 bytes of arrival time then the data.  */
+#define IR_UART_RECORD_SIZE 9
+
+
+typedef struct
+{
+    uint64_t when;
+    uint8_t data;
+} ir_uart_byte_t;
+
+
+static const char *socket_path;
+static int listen_fd = -1;
+static int peer_fd = -1;
+
+static uint8_t echo;
+static double loss;
+static double corrupt;
+static uint64_t rng = 1;
+
+/* When the transmitter finishes the bytes written so far.  */
+static uint64_t tx_free;
+
+static ir_uart_byte_t rx_buffer[IR_UART_RX_BUFFER_SIZE];
+static uint8_t rx_head;
+static uint8_t rx_tail;
+
+/* Part of a record read from the socket.  */
+static uint8_t record[IR_UART_RECORD_SIZE];
+static uint8_t record_size;
+
+
+static uint64_t
+ir_uart_now (void)
+{
+    struct timespec time;
+
+    clock_gettime (CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+
+/** Return a pseudo-random number in [0, 1).  */
+static double
+ir_uart_random (void)
+{
+    /* xorshift64*  */
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return ((rng * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+/** Get a number from an environment variable.  */
+static double
+ir_uart_env (const char *name)
+{
+    const char *value;
+
+    value = getenv (name);
+    return value ? atof (value) : 0;
+}
+
+
+static void
+ir_uart_address (struct sockaddr_un *addr)
+{
+    memset (addr, 0, sizeof (*addr));
+    addr->sun_family = AF_UNIX;
+    strncpy (addr->sun_path, socket_path, sizeof (addr->sun_path) - 1);
+}
+
+
+/** Connect to the other program if not already connected.  */
+static void
+ir_uart_connect (void)
+{
+    struct sockaddr_un addr;
+
+    if (peer_fd >= 0 || !socket_path)
+        return;
+
+    if (listen_fd >= 0)
+    {
+        peer_fd = accept (listen_fd, NULL, NULL);
+        if (peer_fd >= 0)
+            fcntl (peer_fd, F_SETFL, O_NONBLOCK);
+        return;
+    }
+
+    ir_uart_address (&addr);
+
+    /* Try to connect to a listening program.  */
+    peer_fd = socket (AF_UNIX, SOCK_STREAM, 0);
+    if (peer_fd < 0)
+        return;
+    if (connect (peer_fd, (struct sockaddr *) &addr, sizeof (addr)) == 0)
+    {
+        fcntl (peer_fd, F_SETFL, O_NONBLOCK);
+        return;
+    }
+    close (peer_fd);
+    peer_fd = -1;
+
+    /* Otherwise listen, removing any socket left by an earlier run.  */
+    listen_fd = socket (AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+        return;
+    unlink (socket_path);
+    if (bind (listen_fd, (struct sockaddr *) &addr, sizeof (addr)) < 0
+        || listen (listen_fd, 1) < 0)
+    {
+        perror (socket_path);
+        close (listen_fd);
+        listen_fd = -1;
+        socket_path = NULL;
+        return;
+    }
+    fcntl (listen_fd, F_SETFL, O_NONBLOCK);
+}
+
+
+/** Add a byte to the receive buffer, dropping it if the buffer is full.  */
+static void
+ir_uart_receive (uint64_t when, uint8_t data)
+{
+    if ((uint8_t)(rx_tail - rx_head) >= IR_UART_RX_BUFFER_SIZE)
+        return;
+
+    rx_buffer[rx_tail & IR_UART_RX_MASK].when = when;
+    rx_buffer[rx_tail & IR_UART_RX_MASK].data = data;
+    rx_tail++;
+}
+
+
+/** Move whatever the other program has sent into the receive buffer.  */
+static void
+ir_uart_poll (void)
+{
+    ssize_t size;
+
+    ir_uart_connect ();
+    if (peer_fd < 0)
+        return;
+
+    while (1)
+    {
+        size = read (peer_fd, record + record_size,
+                     IR_UART_RECORD_SIZE - record_size);
+        if (size <= 0)
+            break;
+
+        record_size += size;
+        if (record_size == IR_UART_RECORD_SIZE)
+        {
+            uint64_t when;
+
+            memcpy (&when, record, sizeof (when));
+            ir_uart_receive (when, record[sizeof (when)]);
+            record_size = 0;
+        }
+    }
+
+    /* The other program has gone; wait for it to come back.  */
+    if (size == 0 || (size < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+    {
+        close (peer_fd);
+        peer_fd = -1;
+        record_size = 0;
+    }
+}
+
+
+/** Send a byte, applying any loss and corruption.  */
+static void
+ir_uart_send (uint64_t when, uint8_t data)
+{
+    uint8_t buffer[IR_UART_RECORD_SIZE];
+    uint8_t bit;
+
+    if (echo)
+        ir_uart_receive (when, data);
+
+    if (loss && ir_uart_random () < loss)
+        return;
+
+    if (corrupt)
+    {
+        for (bit = 0; bit < 8; bit++)
+        {
+            if (ir_uart_random () < corrupt)
+                data ^= BIT (bit);
+        }
+    }
+
+    ir_uart_connect ();
+    if (peer_fd < 0)
+        return;
+
+    memcpy (buffer, &when, sizeof (when));
+    buffer[sizeof (when)] = data;
+    send (peer_fd, buffer, sizeof (buffer), MSG_NOSIGNAL);
+}
 
 
 /* Return non-zero if there is a character ready to be read.  */
 bool
 ir_uart_read_ready_p (void)
 {
-    return 0;
+    bool ready;
+
+    ir_uart_poll ();
+
+    ready = rx_head != rx_tail
+        && rx_buffer[rx_head & IR_UART_RX_MASK].when <= ir_uart_now ();
+    return system_record_ir_flag (SYSTEM_RECORD_IR_READ_READY, ready);
 }
 
 
@@ -20,7 +268,59 @@ ir_uart_read_ready_p (void)
 int8_t
 ir_uart_getc (void)
 {
-    return 0;
+    char ch;
+
+    while (!ir_uart_read (&ch, 1))
+        usleep (100);
+
+    return ch;
+}
+
+
+/** Read up to size bytes received from IR_UART.
+    @return number of bytes read.  */
+uint8_t
+ir_uart_read (void *data, uint8_t size)
+{
+    uint8_t *dst = data;
+    uint8_t count;
+
+    for (count = 0; count < size && ir_uart_read_ready_p (); count++)
+    {
+        uint8_t ch = 0;
+
+        /* When replaying, the byte comes from the recording.  */
+        if (rx_head != rx_tail)
+        {
+            ch = rx_buffer[rx_head & IR_UART_RX_MASK].data;
+            rx_head++;
+        }
+        dst[count] = system_record_ir_data (ch);
+    }
+    return count;
+}
+
+
+/** Write up to size bytes to IR_UART.
+    @return number of bytes written.  */
+uint8_t
+ir_uart_write (const void *data, uint8_t size)
+{
+    const uint8_t *src = data;
+    uint8_t count;
+    uint64_t now;
+
+    for (count = 0; count < size && ir_uart_write_ready_p (); count++)
+    {
+        now = ir_uart_now ();
+        if (tx_free < now)
+            tx_free = now;
+        tx_free += IR_UART_CHAR_NS;
+
+        system_record_ir_tx (src[count]);
+        ir_uart_send (tx_free, src[count]);
+    }
+    return count;
 }
 
 
@@ -28,7 +328,11 @@ ir_uart_getc (void)
 bool
 ir_uart_write_ready_p (void)
 {
-    return 0;
+    uint64_t now;
+
+    now = ir_uart_now ();
+    return system_record_ir_flag (SYSTEM_RECORD_IR_WRITE_READY,
+                                  tx_free < now + IR_UART_TX_BUFFER_SIZE * IR_UART_CHAR_NS);
 }
 
 
@@ -36,23 +340,31 @@ ir_uart_write_ready_p (void)
 bool
 ir_uart_write_finished_p (void)
 {
-    return 1;
+    return system_record_ir_flag (SYSTEM_RECORD_IR_WRITE_FINISHED,
+                                  tx_free <= ir_uart_now ());
 }
 
 
 /* Write character to IR_UART.  This returns zero if
    the character could not be written.  */
 int8_t
-ir_uart_putc (__unused__ char ch)
+ir_uart_putc (char ch)
 {
-    return 0;
+    return ir_uart_write (&ch, 1);
 }
 
 
 /* Write string to IR_UART.  */
 void
-ir_uart_puts (__unused__ const char *str)
+ir_uart_puts (const char *str)
 {
+    while (*str)
+    {
+        if (!ir_uart_putc (*str))
+            usleep (100);
+        else
+            str++;
+    }
 }
 
 
@@ -60,5 +372,16 @@ ir_uart_puts (__unused__ const char *str)
 uint8_t
 ir_uart_init (void)
 {
-    return 0;
+    const char *seed;
+
+    socket_path = getenv ("IR_UART_SOCKET");
+    echo = ir_uart_env ("IR_UART_ECHO") != 0;
+    loss = ir_uart_env ("IR_UART_LOSS");
+    corrupt = ir_uart_env ("IR_UART_CORRUPT");
+
+    seed = getenv ("IR_UART_SEED");
+    rng = (seed ? strtoull (seed, NULL, 0) : (uint64_t) getpid ()) | 1;
+
+    ir_uart_connect ();
+    return 1;
 }
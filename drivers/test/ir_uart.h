@@ -24,6 +24,22 @@ int8_t
 ir_uart_getc (void);
 
 
+/** Read up to size bytes received from IR_UART.  This does not block.
+    @param data buffer to fill
+    @param size maximum number of bytes to read
+    @return number of bytes read.  */
+uint8_t
+ir_uart_read (void *data, uint8_t size);
+
+
+/** Write up to size bytes to IR_UART.  This does not block.
+    @param data bytes to write
+    @param size number of bytes to write
+    @return number of bytes written.  */
+uint8_t
+ir_uart_write (const void *data, uint8_t size);
+
+
 /* Return non-zero if a character can be written without blocking.  */
 bool
 ir_uart_write_ready_p (void);
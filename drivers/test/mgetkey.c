@@ -89,6 +89,11 @@ int mgetkey (void)
 
     key = getchar ();
     if (key == -1)
+    {
+	/* Nothing typed.  Clear the end-of-file indicator since some C
+	   libraries will not read again while it is set.  */
+	clearerr (stdin);
 	key = 0;
+    }
     return key;
 }
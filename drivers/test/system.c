@@ -2,14 +2,22 @@
     @author M. P. Hayes, UCECE
     @date   15 May 2007
     @brief  Test scaffold for UCFK4.
+
+    The LED matrix is drawn on the terminal below the cursor and only
+    the pixels that change are redrawn.  If the environment variable
+    SYSTEM_HEADLESS is set to a non-zero value, nothing is drawn and
+    the keyboard is not read; the displayed pixels can still be read
+    with system_display_column_get.
 */
 
 #include "system.h"
 #include "avrtest.h"
 #include "pio.h"
 #include "mgetkey.h"
+#include "timer.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <signal.h>
 #include <time.h>
@@ -54,42 +62,140 @@ typedef enum {NAVSWITCH_NONE, NAVSWITCH_EAST, NAVSWITCH_SOUTH,
 typedef enum {BUTTON_NONE, BUTTON_1} system_button_t;
 
 
+/* Persistence filter coefficient scaled by 256.  The filter has an
+   impulse response of exp(-t / tau) u(t) where tau is the persistence
+   period.  */
+#define SYSTEM_DISPLAY_ALPHA \
+    ((uint16_t) (256 * SYSTEM_DISPLAY_PERSISTENCE_PERIOD \
+                 / (SYSTEM_DISPLAY_PERSISTENCE_PERIOD + 1.0 / SYSTEM_UPDATE_RATE)))
+
+/* Filtered brightness of a pixel that is always on.  */
+#define SYSTEM_DISPLAY_LEVEL_MAX 1000
+
+/* A pixel is shown lit while its brightness is above 1%.  */
+#define SYSTEM_DISPLAY_LEVEL_VISIBLE (SYSTEM_DISPLAY_LEVEL_MAX / 100)
+
+/* Longest output for one frame: every pixel moved to and drawn.  */
+#define SYSTEM_DISPLAY_BUFFER_SIZE (LEDMAT_ROWS_NUM * LEDMAT_COLS_NUM * 16 + 16)
+
+
+/* Filtered pixel brightness.  */
+static uint16_t system_display_level[LEDMAT_ROWS_NUM][LEDMAT_COLS_NUM];
+
+/* Pixels shown after persistence; bit n of each column is row n.  */
+static uint8_t system_display_columns[LEDMAT_COLS_NUM];
+
+/* The characters on the terminal, zero before the first frame.  */
+static char system_display_shown[LEDMAT_ROWS_NUM][LEDMAT_COLS_NUM];
+
+/* Non-zero to skip drawing and keyboard reading.  */
+static bool system_headless;
+
+/* Whether a session is being recorded or replayed, see below.  */
+static enum {SYSTEM_RECORD_OFF, SYSTEM_RECORD_WRITE,
+             SYSTEM_RECORD_READ} system_record_mode;
+
+
+/* Draw the changes to the displayed frame with a single write.  The
+   frame is drawn below the cursor, which is left where it was.  */
+static void system_display_render (void)
+{
+    char buffer[SYSTEM_DISPLAY_BUFFER_SIZE];
+    int size = 0;
+    int row;
+    int col;
+
+    if (!system_display_shown[0][0])
+    {
+        /* Draw the whole frame, then move the cursor back up.  */
+        for (row = 0; row < LEDMAT_ROWS_NUM; row++)
+        {
+            for (col = 0; col < LEDMAT_COLS_NUM; col++)
+            {
+                system_display_shown[row][col] =
+                    system_display_columns[col] & BIT (row) ? '@' : '.';
+                buffer[size++] = system_display_shown[row][col];
+            }
+            buffer[size++] = '\n';
+        }
+        size += sprintf (buffer + size, "\n\e[%dA", LEDMAT_ROWS_NUM + 1);
+    }
+    else
+    {
+        for (row = 0; row < LEDMAT_ROWS_NUM; row++)
+        {
+            for (col = 0; col < LEDMAT_COLS_NUM; col++)
+            {
+                char ch;
+
+                ch = system_display_columns[col] & BIT (row) ? '@' : '.';
+                if (ch == system_display_shown[row][col])
+                    continue;
+                system_display_shown[row][col] = ch;
+
+                /* Save the cursor before the first change and return
+                   to it before each one.  */
+                size += sprintf (buffer + size, size ? "\e8" : "\e7");
+                if (row)
+                    size += sprintf (buffer + size, "\e[%dB", row);
+                if (col)
+                    size += sprintf (buffer + size, "\e[%dC", col);
+                buffer[size++] = ch;
+            }
+        }
+        if (!size)
+            return;
+        size += sprintf (buffer + size, "\e8");
+    }
+
+    if (write (STDOUT_FILENO, buffer, size) < 0)
+        return;
+}
+
+
 static void system_display_update (void)
 {
     int row;
     int col;
-    /* Persistence time (s).  */
-    double tau = SYSTEM_DISPLAY_PERSISTENCE_PERIOD;
-    /* Sample period (s).  */
-    double delta_t;
-    /* Exponential filter parameter.  */
-    double alpha;
-    static uint8_t tdisplay[LEDMAT_ROWS_NUM][LEDMAT_COLS_NUM];
-
-    delta_t = 1.0 / SYSTEM_UPDATE_RATE;
-    alpha = tau / (tau + delta_t);
-
-    for (row = 0; row < LEDMAT_ROWS_NUM; row++)
+    uint8_t columns[LEDMAT_COLS_NUM];
+    bool changed = 0;
+
+    for (col = 0; col < LEDMAT_COLS_NUM; col++)
     {
-        for (col = 0; col < LEDMAT_COLS_NUM; col++)
+        columns[col] = 0;
+        for (row = 0; row < LEDMAT_ROWS_NUM; row++)
         {
+            uint16_t *level = &system_display_level[row][col];
             uint8_t on;
 
             /* Determine if pixel is on.  */
             on = !pio_output_get (ledmat_rows[row])
                 && !pio_output_get (ledmat_cols[col]);
 
-            /* Apply exponential filter to provide some persistence.
-               This has an impulse response of exp(-t / tau) u(t).  */
-            tdisplay[row][col] = tdisplay[row][col] * alpha + (1 - alpha) * 100 * on;
+            /* Apply exponential filter to provide some persistence.  */
+            *level = ((uint32_t) *level * SYSTEM_DISPLAY_ALPHA
+                      + (256 - SYSTEM_DISPLAY_ALPHA) * SYSTEM_DISPLAY_LEVEL_MAX * on)
+                >> 8;
 
-            printf ("%c", tdisplay[row][col] > 1 ? '@' : '.');
+            if (*level > SYSTEM_DISPLAY_LEVEL_VISIBLE)
+                columns[col] |= BIT (row);
         }
-        printf ("\n");
+        if (columns[col] != system_display_columns[col])
+            changed = 1;
+        system_display_columns[col] = columns[col];
     }
-    printf ("\n");
-    /* Move cursor up.  */
-    printf ("\e[%dA", LEDMAT_ROWS_NUM + 1);
+
+    if (!system_headless && (changed || !system_display_shown[0][0]))
+        system_display_render ();
+}
+
+
+/** Get a column of the LED matrix as it appears after persistence.
+    @param col column number
+    @return bit n set if row n is lit.  */
+uint8_t system_display_column_get (uint8_t col)
+{
+    return system_display_columns[col];
 }
 
 
@@ -311,7 +417,8 @@ static void system_keyboard_update (void)
 static void system_update (void)
 {
     system_display_update ();
-    system_keyboard_update ();
+    if (!system_headless && system_record_mode != SYSTEM_RECORD_READ)
+        system_keyboard_update ();
 }
 
 
@@ -394,9 +501,537 @@ static int system_interrupt_init (sighandler_t handler, int rate)
 }
 
 
+/* Session recording and replay.
+
+   A recording logs everything the program observes from outside:
+   the time, the navswitch and button pins, and received IR bytes.
+   It also logs what the program shows: the LED matrix columns and
+   sent IR bytes.  The timer and IR UART pass each observation
+   through system_record_observe, which numbers them.  An event is
+   logged with the number of the observation it belongs to, and only
+   when the value changes.
+
+   When recording, the display and keyboard are polled at
+   observations rather than from a signal.  The keyboard then
+   changes the inputs only between observations, so the log captures
+   exactly what the program sees.  When replaying, the logged inputs
+   are fed back at the same observations as fast as the program
+   runs, and the frames and sent bytes must match.
+
+   Each event is a type byte, the number of observations since the
+   previous event as a base-128 varint, and then its data.  */
+
+#define SYSTEM_RECORD_MAGIC "UCFKREC\1"
+
+/* Number of ports with input pins: B, C, and D.  */
+#define SYSTEM_RECORD_PORTS 3
+
+enum
+{
+    SYSTEM_EVENT_END,
+    SYSTEM_EVENT_TIME,       /* Varint of the change in ticks.  */
+    SYSTEM_EVENT_INPUT,      /* PIN registers for ports B, C, D.  */
+    SYSTEM_EVENT_IR_DATA,    /* Received byte.  */
+    SYSTEM_EVENT_IR_TX,      /* Sent byte.  */
+    SYSTEM_EVENT_FRAME,      /* LED matrix columns.  */
+    SYSTEM_EVENT_IR_FLAG     /* No data; toggles an IR UART flag.  */
+};
+
+typedef struct
+{
+    uint8_t type;
+    uint64_t index;
+    uint8_t data[LEDMAT_COLS_NUM];
+    uint16_t value;
+} system_event_t;
+
+static FILE *system_record_file;
+
+/* Number of observations so far and at the last event.  */
+static uint64_t system_record_index;
+static uint64_t system_record_event_index;
+
+/* Values as of the last event.  */
+static uint8_t system_record_pins[SYSTEM_RECORD_PORTS];
+static uint8_t system_record_frame[LEDMAT_COLS_NUM];
+static uint16_t system_record_time;
+static bool system_record_flags[SYSTEM_RECORD_IR_FLAGS];
+
+/* The next event when replaying.  */
+static system_event_t system_record_next;
+
+/* Statistics for the replay report.  */
+static uint64_t system_record_ticks;
+
+/* Non-zero until the change of time that sets the starting time.  */
+static bool system_record_time_base = 1;
+static unsigned long system_record_frames;
+static struct timespec system_record_start;
+
+
+static void system_update (void);
+
+
+static volatile uint8_t *system_record_pin (uint8_t port)
+{
+    return &PORTB + port * (&PORTC - &PORTB) + (&PINB - &PORTB);
+}
+
+
+/* Update the LED matrix frame with the column being driven.  */
+static void system_record_frame_sample (uint8_t *frame)
+{
+    int row;
+    int col;
+
+    for (col = 0; col < LEDMAT_COLS_NUM; col++)
+    {
+        if (pio_config_get (ledmat_cols[col]) != PIO_OUTPUT_LOW)
+            continue;
+
+        frame[col] = 0;
+        for (row = 0; row < LEDMAT_ROWS_NUM; row++)
+        {
+            if (!pio_output_get (ledmat_rows[row]))
+                frame[col] |= BIT (row);
+        }
+    }
+}
+
+
+static void system_record_varint_write (uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        putc ((value & 0x7f) | 0x80, system_record_file);
+        value >>= 7;
+    }
+    putc (value, system_record_file);
+}
+
+
+static uint64_t system_record_varint_read (void)
+{
+    uint64_t value = 0;
+    int shift = 0;
+    int ch;
+
+    do
+    {
+        ch = getc (system_record_file);
+        if (ch == EOF)
+            return 0;
+        value |= (uint64_t) (ch & 0x7f) << shift;
+        shift += 7;
+    } while (ch & 0x80);
+
+    return value;
+}
+
+
+static void system_record_write (uint8_t type, const uint8_t *data,
+                                 uint8_t size)
+{
+    putc (type, system_record_file);
+    system_record_varint_write (system_record_index
+                                - system_record_event_index);
+    system_record_event_index = system_record_index;
+    if (size)
+        fwrite (data, 1, size, system_record_file);
+}
+
+
+/* Read the next event to replay.  A truncated log reads as an end
+   event.  */
+static void system_record_read (void)
+{
+    system_event_t *event = &system_record_next;
+    int type;
+    uint8_t size;
+
+    type = getc (system_record_file);
+    event->type = type == EOF ? SYSTEM_EVENT_END : type;
+    event->index += system_record_varint_read ();
+
+    switch (event->type)
+    {
+    case SYSTEM_EVENT_TIME:
+        event->value = system_record_varint_read ();
+        return;
+
+    case SYSTEM_EVENT_INPUT:
+        size = SYSTEM_RECORD_PORTS;
+        break;
+
+    case SYSTEM_EVENT_IR_DATA:
+    case SYSTEM_EVENT_IR_TX:
+        size = 1;
+        break;
+
+    case SYSTEM_EVENT_FRAME:
+        size = LEDMAT_COLS_NUM;
+        break;
+
+    default:
+        return;
+    }
+    if (fread (event->data, 1, size, system_record_file) != size)
+        event->type = SYSTEM_EVENT_END;
+}
+
+
+static void system_record_close (void)
+{
+    if (system_record_mode == SYSTEM_RECORD_WRITE)
+    {
+        system_record_write (SYSTEM_EVENT_END, NULL, 0);
+        fclose (system_record_file);
+    }
+    system_record_mode = SYSTEM_RECORD_OFF;
+}
+
+
+/* Print the replay result and exit.  */
+static void system_record_finish (const char *failure)
+{
+    struct timespec now;
+    double wall;
+    double recorded;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    wall = (now.tv_sec - system_record_start.tv_sec)
+        + (now.tv_nsec - system_record_start.tv_nsec) * 1e-9;
+    recorded = (double) system_record_ticks / TIMER_RATE;
+
+    system_record_mode = SYSTEM_RECORD_OFF;
+    if (failure)
+    {
+        fprintf (stderr, "replay failed at observation %llu (%.3f s): %s\n",
+                 (unsigned long long) system_record_index, recorded, failure);
+        exit (EXIT_FAILURE);
+    }
+
+    fprintf (stderr, "replay passed: %lu frames, %.1f s recorded, "
+             "replayed in %.3f s (%.0fx)\n",
+             system_record_frames, recorded, wall,
+             wall > 0 ? recorded / wall : 0);
+    exit (EXIT_SUCCESS);
+}
+
+
+/* Poll the display and keyboard at their update rate while recording.  */
+static void system_record_poll (void)
+{
+    static uint64_t next;
+    struct timespec time;
+    uint64_t now;
+
+    clock_gettime (CLOCK_MONOTONIC, &time);
+    now = (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+    if (now < next)
+        return;
+
+    next = now + 1000000000 / SYSTEM_UPDATE_RATE;
+    system_update ();
+}
+
+
+static void system_record_init (void)
+{
+    const char *filename;
+    char magic[sizeof (SYSTEM_RECORD_MAGIC) - 1];
+
+    filename = getenv ("SYSTEM_REPLAY");
+    if (filename)
+    {
+        system_record_file = fopen (filename, "rb");
+        if (!system_record_file
+            || fread (magic, 1, sizeof (magic), system_record_file) != sizeof (magic)
+            || memcmp (magic, SYSTEM_RECORD_MAGIC, sizeof (magic)))
+        {
+            fprintf (stderr, "%s: not a recording\n", filename);
+            exit (EXIT_FAILURE);
+        }
+        system_record_mode = SYSTEM_RECORD_READ;
+        system_record_read ();
+        clock_gettime (CLOCK_MONOTONIC, &system_record_start);
+        return;
+    }
+
+    filename = getenv ("SYSTEM_RECORD");
+    if (filename)
+    {
+        system_record_file = fopen (filename, "wb");
+        if (!system_record_file)
+        {
+            perror (filename);
+            exit (EXIT_FAILURE);
+        }
+        fwrite (SYSTEM_RECORD_MAGIC, 1, sizeof (magic), system_record_file);
+        system_record_mode = SYSTEM_RECORD_WRITE;
+        atexit (system_record_close);
+    }
+}
+
+
+/* Log the inputs, frame, and value at an observation.  */
+static void system_record_log (uint8_t type, uint16_t value)
+{
+    uint8_t pins[SYSTEM_RECORD_PORTS];
+    uint8_t frame[LEDMAT_COLS_NUM];
+    uint8_t port;
+
+    for (port = 0; port < SYSTEM_RECORD_PORTS; port++)
+        pins[port] = *system_record_pin (port);
+    if (memcmp (pins, system_record_pins, sizeof (pins)))
+    {
+        memcpy (system_record_pins, pins, sizeof (pins));
+        system_record_write (SYSTEM_EVENT_INPUT, pins, sizeof (pins));
+    }
+
+    memcpy (frame, system_record_frame, sizeof (frame));
+    system_record_frame_sample (frame);
+    if (memcmp (frame, system_record_frame, sizeof (frame)))
+    {
+        memcpy (system_record_frame, frame, sizeof (frame));
+        system_record_write (SYSTEM_EVENT_FRAME, frame, sizeof (frame));
+    }
+
+    if (type >= SYSTEM_EVENT_IR_FLAG)
+    {
+        if (value != system_record_flags[type - SYSTEM_EVENT_IR_FLAG])
+        {
+            system_record_write (type, NULL, 0);
+            system_record_flags[type - SYSTEM_EVENT_IR_FLAG] = value;
+        }
+        return;
+    }
+
+    switch (type)
+    {
+    case SYSTEM_EVENT_TIME:
+        if (value != system_record_time)
+        {
+            system_record_write (type, NULL, 0);
+            system_record_varint_write ((uint16_t) (value - system_record_time));
+            system_record_time = value;
+        }
+        break;
+
+    case SYSTEM_EVENT_IR_DATA:
+    case SYSTEM_EVENT_IR_TX:
+        pins[0] = value;
+        system_record_write (type, pins, 1);
+        break;
+    }
+}
+
+
+/* Replay the events for an observation and return the logged value.  */
+static uint16_t system_record_replay (uint8_t type, uint16_t value)
+{
+    system_event_t *next = &system_record_next;
+    uint8_t frame[LEDMAT_COLS_NUM];
+    bool frame_checked = 0;
+    uint8_t port;
+
+    if (next->type == SYSTEM_EVENT_END && next->index <= system_record_index)
+        system_record_finish (NULL);
+    if (next->index < system_record_index)
+        system_record_finish ("expected output not produced");
+
+    memcpy (frame, system_record_frame, sizeof (frame));
+    system_record_frame_sample (frame);
+
+    while (next->index == system_record_index)
+    {
+        if (next->type == SYSTEM_EVENT_INPUT)
+        {
+            for (port = 0; port < SYSTEM_RECORD_PORTS; port++)
+                *system_record_pin (port) = next->data[port];
+        }
+        else if (next->type == SYSTEM_EVENT_FRAME)
+        {
+            if (memcmp (frame, next->data, sizeof (frame)))
+                system_record_finish ("frame differs");
+            frame_checked = 1;
+            system_record_frames++;
+        }
+        else
+            break;
+        system_record_read ();
+    }
+
+    if (!frame_checked && memcmp (frame, system_record_frame, sizeof (frame)))
+        system_record_finish ("frame changed");
+    memcpy (system_record_frame, frame, sizeof (frame));
+
+    if (next->index == system_record_index && next->type == type)
+    {
+        switch (type)
+        {
+        case SYSTEM_EVENT_TIME:
+            /* The change that sets the starting time is not play.  */
+            if (!system_record_time_base)
+                system_record_ticks += next->value;
+            system_record_time_base = 0;
+            system_record_time += next->value;
+            break;
+
+        case SYSTEM_EVENT_IR_DATA:
+            value = next->data[0];
+            break;
+
+        default:
+            system_record_flags[type - SYSTEM_EVENT_IR_FLAG] ^= 1;
+            break;
+        }
+        system_record_read ();
+    }
+    else if (type == SYSTEM_EVENT_IR_DATA
+             || (next->index == system_record_index
+                 && next->type != SYSTEM_EVENT_IR_TX
+                 && next->type != SYSTEM_EVENT_END))
+        system_record_finish ("program diverged");
+
+    if (type >= SYSTEM_EVENT_IR_FLAG)
+        return system_record_flags[type - SYSTEM_EVENT_IR_FLAG];
+    if (type == SYSTEM_EVENT_TIME)
+        return system_record_time;
+    return value;
+}
+
+
+/* Non-zero once an interrupt or termination signal has arrived.  */
+static volatile sig_atomic_t system_exit_requested;
+
+
+static uint16_t system_record_observe (uint8_t type, uint16_t value)
+{
+    /* Every program reads the timer or the IR UART, so this is where
+       an exit asked for by a signal is carried out.  */
+    if (system_exit_requested)
+        exit (EXIT_SUCCESS);
+
+    switch (system_record_mode)
+    {
+    case SYSTEM_RECORD_WRITE:
+        system_record_poll ();
+        system_record_index++;
+        system_record_log (type, value);
+        return value;
+
+    case SYSTEM_RECORD_READ:
+        system_record_poll ();
+        system_record_index++;
+        return system_record_replay (type, value);
+
+    default:
+        return value;
+    }
+}
+
+
+/** Pass the time read by the timer through the recorder.
+    @param now current time
+    @return time to use.  */
+uint16_t system_record_time_get (uint16_t now)
+{
+    return system_record_observe (SYSTEM_EVENT_TIME, now);
+}
+
+
+/** Mark the next change of time as a new starting time rather than
+    time passing.  The timer calls this when timer_init moves its
+    origin, so that the jump is not counted as recorded time.  */
+void system_record_time_restart (void)
+{
+    system_record_time_base = 1;
+}
+
+
+/** Pass an IR UART status flag through the recorder.
+    @param flag which flag
+    @param value state of the flag
+    @return state to use.  */
+bool system_record_ir_flag (system_record_ir_flag_t flag, bool value)
+{
+    return system_record_observe (SYSTEM_EVENT_IR_FLAG + flag, value);
+}
+
+
+/** Pass a received IR byte through the recorder.
+    @param data received byte
+    @return byte to use.  */
+uint8_t system_record_ir_data (uint8_t data)
+{
+    return system_record_observe (SYSTEM_EVENT_IR_DATA, data);
+}
+
+
+/** Log or check a sent IR byte.
+    @param data sent byte.  */
+void system_record_ir_tx (uint8_t data)
+{
+    system_event_t *next = &system_record_next;
+
+    if (system_record_mode == SYSTEM_RECORD_WRITE)
+        system_record_write (SYSTEM_EVENT_IR_TX, &data, 1);
+    else if (system_record_mode == SYSTEM_RECORD_READ)
+    {
+        if (next->type != SYSTEM_EVENT_IR_TX
+            || next->index != system_record_index
+            || next->data[0] != data)
+            system_record_finish ("sent IR byte differs");
+        system_record_read ();
+    }
+}
+
+
+/** Return non-zero if replaying a recording.  The timer does not
+    sleep when replaying.  */
+bool system_record_replay_p (void)
+{
+    return system_record_mode == SYSTEM_RECORD_READ;
+}
+
+
+/* Ask for a normal exit on an interrupt or termination signal, so
+   that the functions registered with atexit run, say to restore the
+   terminal or print statistics.  exit is not safe to call from a
+   signal handler, so it is called at the next observation instead.
+   A second signal, for a program that is stuck, exits at once.  */
+static void
+system_exit_handler (__unused__ int sig)
+{
+    static const char message[] = "exiting without cleanup\n";
+    ssize_t written;
+
+    if (system_exit_requested)
+    {
+        written = write (STDERR_FILENO, message, sizeof (message) - 1);
+        (void) written;
+        _exit (EXIT_FAILURE);
+    }
+    system_exit_requested = 1;
+}
+
+
 void system_init (void)
 {
+    const char *headless;
+
+    headless = getenv ("SYSTEM_HEADLESS");
+    system_headless = headless && atoi (headless) != 0;
+
+    signal (SIGINT, system_exit_handler);
+    signal (SIGTERM, system_exit_handler);
+
     system_keyboard_init ();
 
-    system_interrupt_init (system_handler, SYSTEM_UPDATE_RATE);
+    /* When recording or replaying, the display and keyboard are
+       polled by the timer and IR UART instead.  */
+    system_record_init ();
+    if (system_record_mode == SYSTEM_RECORD_OFF)
+        system_interrupt_init (system_handler, SYSTEM_UPDATE_RATE);
 }
@@ -8,8 +8,7 @@
 
 /* Data typedefs.  */
 #include <stdint.h>
-
-typedef uint8_t bool;
+#include <stdbool.h>
 
 
 /* Useful macros.  */
@@ -71,4 +70,62 @@ typedef uint8_t bool;
 
 void system_init (void);
 
+
+/** Get a column of the LED matrix as it appears after persistence.
+    This is only provided by the test scaffold.
+    @param col column number
+    @return bit n set if row n is lit.  */
+uint8_t system_display_column_get (uint8_t col);
+
+
+/* Session recording and replay.  If the environment variable
+   SYSTEM_RECORD names a file, system_init starts logging the inputs
+   and outputs of the program to it.  If SYSTEM_REPLAY names a file,
+   the logged inputs are fed back as fast as possible, the outputs are
+   checked, and the program exits with a pass or fail report.  The
+   timer and IR UART of the test scaffold call these functions.  */
+
+/** Pass the time read by the timer through the recorder.
+    @param now current time
+    @return time to use.  */
+uint16_t system_record_time_get (uint16_t now);
+
+
+/** Mark the next change of time as a new starting time rather than
+    time passing.  Called by timer_init.  */
+void system_record_time_restart (void);
+
+
+/** IR UART status flags that are recorded.  */
+typedef enum
+{
+    SYSTEM_RECORD_IR_READ_READY,
+    SYSTEM_RECORD_IR_WRITE_READY,
+    SYSTEM_RECORD_IR_WRITE_FINISHED,
+    SYSTEM_RECORD_IR_FLAGS
+} system_record_ir_flag_t;
+
+
+/** Pass an IR UART status flag through the recorder.
+    @param flag which flag
+    @param value state of the flag
+    @return state to use.  */
+bool system_record_ir_flag (system_record_ir_flag_t flag, bool value);
+
+
+/** Pass a received IR byte through the recorder.
+    @param data received byte
+    @return byte to use.  */
+uint8_t system_record_ir_data (uint8_t data);
+
+
+/** Log or check a sent IR byte.
+    @param data sent byte.  */
+void system_record_ir_tx (uint8_t data);
+
+
+/** Return non-zero if replaying a recording.  The timer does not
+    sleep when replaying.  */
+bool system_record_replay_p (void);
+
 #endif
@@ -2,6 +2,18 @@
     @author M. P. Hayes, UCECE
     @date   21 August 2007
     Description:  Support for timer.  
+
+    The timer normally follows CLOCK_MONOTONIC.  If the environment
+    variable TIMER_VIRTUAL is set to a non-zero value, the timer
+    instead counts virtual ticks that only advance when the program
+    waits: timer_wait_until jumps straight to the requested time
+    rather than sleeping.  A program then runs as fast as the host
+    allows and, apart from keyboard input, does the same thing on
+    every run.
+
+    There are no interrupts, so the periodic function is called from
+    timer_get and timer_wait_until when it is due, and waits are cut
+    short to call it on time.
 */
 #include "timer.h"
 #include "unistd.h"
@@ -9,15 +21,90 @@
 #include "system.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 static timer_tick_t offset;
 
+/* Non-zero for virtual time, -1 until TIMER_VIRTUAL has been read.  */
+static int8_t virtual_mode = -1;
+
+static timer_tick_t virtual_now;
+
+static timer_tick_t periodic_period;
+static timer_tick_t periodic_next;
+static timer_callback_t periodic_callback;
+static bool periodic_running;
+
+
+/* Return non-zero if using virtual time.  This is checked on first
+   use since timer_get may be called before timer_init.  */
+static bool timer_virtual_p (void)
+{
+    if (virtual_mode < 0)
+    {
+        const char *value;
+
+        value = getenv ("TIMER_VIRTUAL");
+        virtual_mode = value && atoi (value) != 0;
+    }
+    return virtual_mode;
+}
+
+
+/* Call the periodic function if it is due, as the interrupt would.  */
+static void timer_periodic_poll (timer_tick_t now)
+{
+    /* The function may itself use the timer.  */
+    if (!periodic_callback || periodic_running)
+        return;
+
+    periodic_running = 1;
+    while (periodic_callback
+           && (timer_tick_t)(now - periodic_next) < TIMER_OVERRUN_MAX)
+    {
+        periodic_callback ();
+        periodic_next += periodic_period;
+    }
+
+    /* Drop the calls missed while the program was not using the timer.  */
+    if ((timer_tick_t)(periodic_next - now) > periodic_period)
+        periodic_next = now + periodic_period;
+    periodic_running = 0;
+}
+
+
+/* Return ticks until the periodic function is due, or MAX if sooner.  */
+static timer_tick_t timer_periodic_wait (timer_tick_t now, timer_tick_t max)
+{
+    timer_tick_t diff;
+
+    if (!periodic_callback || periodic_running)
+        return max;
+
+    diff = periodic_next - now;
+    return diff < max ? diff : max;
+}
+
 
 /* Initialise timer.  */
 void timer_init (void)
 {
     /* Save offset so timer starts around 0.  */
-    offset = timer_get ();
+    if (timer_virtual_p ())
+        virtual_now = 0;
+    else
+    {
+        offset = timer_get ();
+
+        /* The next time read jumps to around 0; that is not time
+           passing.  */
+        system_record_time_restart ();
+    }
+
+    /* Keep a periodic function that is already running one period
+       from the restarted time rather than up to a wrap away.  */
+    if (periodic_callback)
+        periodic_next = timer_get () + periodic_period;
 }
 
 
@@ -29,12 +116,24 @@ timer_tick_t timer_get (void)
     uint64_t time_us;
     uint64_t ticks;
 
-    clock_gettime (CLOCK_MONOTONIC, &time);
+    timer_tick_t now;
+
+    if (timer_virtual_p ())
+    {
+        now = system_record_time_get (virtual_now);
+    }
+    else
+    {
+        clock_gettime (CLOCK_MONOTONIC, &time);
+
+        time_us = time.tv_sec * 1000000 + time.tv_nsec / 1000;
+        ticks = time_us * TIMER_RATE / 1000000;
 
-    time_us = time.tv_sec * 1000000 + time.tv_nsec / 1000;
-    ticks = time_us * TIMER_RATE / 1000000;
+        now = system_record_time_get ((timer_tick_t) ticks - offset);
+    }
 
-    return (timer_tick_t) ticks - offset;
+    timer_periodic_poll (now);
+    return now;
 }
 
 
@@ -56,13 +155,50 @@ timer_tick_t timer_wait_until (timer_tick_t when)
         if (diff < TIMER_OVERRUN_MAX)
             return now;
 
-        diff = when - now;
+        diff = timer_periodic_wait (now, when - now);
+
+        if (timer_virtual_p ())
+        {
+            virtual_now = now + diff;
+            continue;
+        }
+
+        /* The recording says when the wait ends.  */
+        if (system_record_replay_p ())
+            continue;
 
         usleep (diff * 1e6 / TIMER_RATE);
     }
 }
 
 
+/** Call a function every period ticks.
+    @param period ticks between calls
+    @param callback function to call.  */
+void timer_periodic_start (timer_tick_t period, timer_callback_t callback)
+{
+    periodic_period = period;
+    periodic_callback = NULL;
+    periodic_next = timer_get () + period;
+    periodic_callback = callback;
+}
+
+
+/** Change the period of the periodic function.
+    @param period ticks between calls.  */
+void timer_periodic_period_set (timer_tick_t period)
+{
+    periodic_period = period;
+}
+
+
+/** Stop calling the periodic function.  */
+void timer_periodic_stop (void)
+{
+    periodic_callback = NULL;
+}
+
+
 /** Wait for specified period:
     @param period how long to wait
     @return current time.  */
@@ -74,6 +74,10 @@
 typedef uint16_t timer_tick_t;
 
 
+/** Function called by the periodic timer.  */
+typedef void (*timer_callback_t) (void);
+
+
 /** Get current time:
     @return current time in ticks.  */
 timer_tick_t timer_get (void);
@@ -91,6 +95,26 @@ timer_tick_t timer_wait_until (timer_tick_t when);
 timer_tick_t timer_wait (timer_tick_t period);
 
 
+/** Call a function every period ticks from the timer compare
+    interrupt.  The function runs with interrupts disabled so it must
+    be short.  This enables interrupts.  It can be called before or
+    after timer_init; timer_init restarts the counter from zero and
+    sets the next call one period after that.
+    @param period ticks between calls
+    @param callback function to call.  */
+void timer_periodic_start (timer_tick_t period, timer_callback_t callback);
+
+
+/** Change the period of the periodic function.  When called from
+    the function, this sets the time until the next call.
+    @param period ticks between calls.  */
+void timer_periodic_period_set (timer_tick_t period);
+
+
+/** Stop calling the periodic function.  */
+void timer_periodic_stop (void);
+
+
 /** Initialise timer.  */
 void timer_init (void);
 
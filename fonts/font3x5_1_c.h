@@ -0,0 +1,162 @@
+/** @file    font3x5_1_c.h
+    @author  fontgen
+    @date    17 Oct 2026
+
+    @defgroup font3x5_1_c  This is a tiny 3x5 font with uppercase, digits, and symbols only.
+ M.P. Hayes 2 Sep 2010
+
+*/
+
+#ifndef FONT3X5_1_C_H_
+#define FONT3X5_1_C_H_
+
+#define FONT3X5_1_C_WIDTH 3
+#define FONT3X5_1_C_HEIGHT 5
+#define FONT3X5_1_C_OFFSET 32
+#define FONT3X5_1_C_SIZE 59
+
+#ifndef FONT_WIDTH
+#define FONT_WIDTH 3
+#endif
+#ifndef FONT_HEIGHT
+#define FONT_HEIGHT 5
+#endif
+#ifndef FONT_OFFSET
+#define FONT_OFFSET 32
+#endif
+#ifndef FONT_SIZE_MAX
+#define FONT_SIZE_MAX 59
+#endif
+#include "font.h"
+
+static font_t font3x5_1_c =
+{
+    .flags = 2, /* (columns)  */
+    .width = 3,
+    .height = 5,
+    .offset = 32,
+    .size = 59,
+    .bytes = 3,
+    .data =
+    {
+        /*    */
+        0x00, 0x00, 0x00, 
+        /* !  */
+        0x00, 0x17, 0x00, 
+        /* "  */
+        0x1f, 0x15, 0x16, 
+        /* #  */
+        0x1f, 0x0a, 0x1f, 
+        /* $  */
+        0x16, 0x1f, 0x0d, 
+        /* %  */
+        0x19, 0x04, 0x13, 
+        /* &  */
+        0x1e, 0x15, 0x1a, 
+        /* '  */
+        0x00, 0x02, 0x01, 
+        /* (  */
+        0x0e, 0x11, 0x00, 
+        /* )  */
+        0x00, 0x11, 0x0e, 
+        /* *  */
+        0x0a, 0x1f, 0x0a, 
+        /* +  */
+        0x04, 0x0e, 0x04, 
+        /* ,  */
+        0x10, 0x08, 0x00, 
+        /* -  */
+        0x04, 0x04, 0x04, 
+        /* .  */
+        0x00, 0x10, 0x00, 
+        /* /  */
+        0x18, 0x04, 0x03, 
+        /* 0  */
+        0x0e, 0x11, 0x0e, 
+        /* 1  */
+        0x12, 0x1f, 0x10, 
+        /* 2  */
+        0x19, 0x15, 0x12, 
+        /* 3  */
+        0x11, 0x15, 0x0a, 
+        /* 4  */
+        0x07, 0x04, 0x1f, 
+        /* 5  */
+        0x13, 0x15, 0x09, 
+        /* 6  */
+        0x0e, 0x15, 0x09, 
+        /* 7  */
+        0x19, 0x05, 0x03, 
+        /* 8  */
+        0x0a, 0x15, 0x0a, 
+        /* 9  */
+        0x02, 0x05, 0x1f, 
+        /* :  */
+        0x00, 0x0a, 0x00, 
+        /* ;  */
+        0x10, 0x0a, 0x00, 
+        /* <  */
+        0x04, 0x0a, 0x11, 
+        /* =  */
+        0x0a, 0x0a, 0x0a, 
+        /* >  */
+        0x11, 0x0a, 0x04, 
+        /* ?  */
+        0x02, 0x19, 0x06, 
+        /* @  */
+        0x00, 0x00, 0x00, 
+        /* A  */
+        0x1e, 0x05, 0x1e, 
+        /* B  */
+        0x1f, 0x15, 0x0a, 
+        /* C  */
+        0x1f, 0x11, 0x11, 
+        /* D  */
+        0x1f, 0x11, 0x0e, 
+        /* E  */
+        0x1f, 0x15, 0x15, 
+        /* F  */
+        0x1f, 0x05, 0x05, 
+        /* G  */
+        0x1f, 0x11, 0x19, 
+        /* H  */
+        0x1f, 0x04, 0x1f, 
+        /* I  */
+        0x11, 0x1f, 0x11, 
+        /* J  */
+        0x18, 0x10, 0x1f, 
+        /* K  */
+        0x1f, 0x0a, 0x11, 
+        /* L  */
+        0x1f, 0x10, 0x10, 
+        /* M  */
+        0x1f, 0x06, 0x1f, 
+        /* N  */
+        0x1f, 0x01, 0x1f, 
+        /* O  */
+        0x1f, 0x11, 0x1f, 
+        /* P  */
+        0x1f, 0x05, 0x07, 
+        /* Q  */
+        0x1f, 0x19, 0x1f, 
+        /* R  */
+        0x1f, 0x0d, 0x17, 
+        /* S  */
+        0x16, 0x15, 0x09, 
+        /* T  */
+        0x01, 0x1f, 0x01, 
+        /* U  */
+        0x1f, 0x10, 0x1f, 
+        /* V  */
+        0x0f, 0x10, 0x0f, 
+        /* W  */
+        0x1f, 0x0c, 0x1f, 
+        /* X  */
+        0x1b, 0x04, 0x1b, 
+        /* Y  */
+        0x03, 0x1c, 0x03, 
+        /* Z  */
+        0x19, 0x15, 0x13, 
+    }
+};
+#endif  /* FONT3X5_1_C_H_  */
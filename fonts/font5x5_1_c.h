@@ -0,0 +1,234 @@
+/** @file    font5x5_1_c.h
+    @author  fontgen
+    @date    17 Oct 2026
+
+    @defgroup font5x5_1_c  This is a 5x7 font with uppercase, lowercase, digits, and symbols.
+ M.P. Hayes 2 Sep 2010
+
+*/
+
+#ifndef FONT5X5_1_C_H_
+#define FONT5X5_1_C_H_
+
+#define FONT5X5_1_C_WIDTH 5
+#define FONT5X5_1_C_HEIGHT 5
+#define FONT5X5_1_C_OFFSET 32
+#define FONT5X5_1_C_SIZE 95
+
+#ifndef FONT_WIDTH
+#define FONT_WIDTH 5
+#endif
+#ifndef FONT_HEIGHT
+#define FONT_HEIGHT 5
+#endif
+#ifndef FONT_OFFSET
+#define FONT_OFFSET 32
+#endif
+#ifndef FONT_SIZE_MAX
+#define FONT_SIZE_MAX 95
+#endif
+#include "font.h"
+
+static font_t font5x5_1_c =
+{
+    .flags = 2, /* (columns)  */
+    .width = 5,
+    .height = 5,
+    .offset = 32,
+    .size = 95,
+    .bytes = 5,
+    .data =
+    {
+        /*    */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* !  */
+        0x00, 0x17, 0x17, 0x00, 0x00, 
+        /* "  */
+        0x00, 0x03, 0x00, 0x03, 0x00, 
+        /* #  */
+        0x0a, 0x1f, 0x0a, 0x1f, 0x0a, 
+        /* $  */
+        0x12, 0x15, 0x1f, 0x15, 0x09, 
+        /* %  */
+        0x11, 0x09, 0x04, 0x12, 0x11, 
+        /* &  */
+        0x0a, 0x15, 0x11, 0x0a, 0x18, 
+        /* '  */
+        0x00, 0x05, 0x03, 0x00, 0x00, 
+        /* (  */
+        0x04, 0x0a, 0x00, 0x11, 0x00, 
+        /* )  */
+        0x00, 0x11, 0x00, 0x0a, 0x04, 
+        /* *  */
+        0x0a, 0x04, 0x1f, 0x04, 0x0a, 
+        /* +  */
+        0x04, 0x04, 0x1f, 0x04, 0x04, 
+        /* ,  */
+        0x00, 0x14, 0x0c, 0x00, 0x00, 
+        /* -  */
+        0x04, 0x04, 0x04, 0x04, 0x04, 
+        /* .  */
+        0x00, 0x18, 0x18, 0x00, 0x00, 
+        /* /  */
+        0x10, 0x08, 0x04, 0x02, 0x01, 
+        /* 0  */
+        0x0e, 0x19, 0x15, 0x13, 0x0e, 
+        /* 1  */
+        0x00, 0x12, 0x1f, 0x10, 0x00, 
+        /* 2  */
+        0x12, 0x19, 0x15, 0x11, 0x12, 
+        /* 3  */
+        0x00, 0x15, 0x15, 0x15, 0x0a, 
+        /* 4  */
+        0x0c, 0x0a, 0x09, 0x1f, 0x08, 
+        /* 5  */
+        0x07, 0x15, 0x15, 0x15, 0x09, 
+        /* 6  */
+        0x0e, 0x15, 0x15, 0x15, 0x08, 
+        /* 7  */
+        0x03, 0x01, 0x11, 0x09, 0x07, 
+        /* 8  */
+        0x0a, 0x15, 0x15, 0x15, 0x0a, 
+        /* 9  */
+        0x02, 0x15, 0x15, 0x15, 0x0e, 
+        /* :  */
+        0x00, 0x1b, 0x1b, 0x00, 0x00, 
+        /* ;  */
+        0x00, 0x1b, 0x0b, 0x00, 0x00, 
+        /* <  */
+        0x04, 0x00, 0x0a, 0x00, 0x11, 
+        /* =  */
+        0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 
+        /* >  */
+        0x11, 0x00, 0x0a, 0x00, 0x04, 
+        /* ?  */
+        0x02, 0x01, 0x15, 0x01, 0x02, 
+        /* @  */
+        0x08, 0x15, 0x1d, 0x11, 0x0e, 
+        /* A  */
+        0x1c, 0x0a, 0x09, 0x0a, 0x1c, 
+        /* B  */
+        0x1f, 0x15, 0x15, 0x15, 0x0a, 
+        /* C  */
+        0x0e, 0x11, 0x11, 0x11, 0x0a, 
+        /* D  */
+        0x1f, 0x11, 0x11, 0x11, 0x0e, 
+        /* E  */
+        0x1f, 0x15, 0x15, 0x15, 0x11, 
+        /* F  */
+        0x1f, 0x05, 0x05, 0x05, 0x01, 
+        /* G  */
+        0x0e, 0x11, 0x15, 0x15, 0x1c, 
+        /* H  */
+        0x1f, 0x04, 0x04, 0x04, 0x1f, 
+        /* I  */
+        0x00, 0x11, 0x1f, 0x11, 0x00, 
+        /* J  */
+        0x0c, 0x10, 0x10, 0x10, 0x0f, 
+        /* K  */
+        0x1f, 0x04, 0x00, 0x0a, 0x11, 
+        /* L  */
+        0x1f, 0x10, 0x10, 0x10, 0x10, 
+        /* M  */
+        0x1f, 0x02, 0x04, 0x02, 0x1f, 
+        /* N  */
+        0x1f, 0x02, 0x04, 0x08, 0x1f, 
+        /* O  */
+        0x0e, 0x11, 0x11, 0x11, 0x0e, 
+        /* P  */
+        0x1f, 0x05, 0x05, 0x05, 0x02, 
+        /* Q  */
+        0x0e, 0x11, 0x11, 0x09, 0x16, 
+        /* R  */
+        0x1f, 0x05, 0x05, 0x05, 0x1a, 
+        /* S  */
+        0x02, 0x15, 0x15, 0x15, 0x08, 
+        /* T  */
+        0x01, 0x01, 0x1f, 0x01, 0x01, 
+        /* U  */
+        0x0f, 0x10, 0x10, 0x10, 0x0f, 
+        /* V  */
+        0x07, 0x08, 0x10, 0x08, 0x07, 
+        /* W  */
+        0x1f, 0x08, 0x04, 0x08, 0x1f, 
+        /* X  */
+        0x11, 0x0a, 0x04, 0x0a, 0x11, 
+        /* Y  */
+        0x03, 0x04, 0x18, 0x04, 0x03, 
+        /* Z  */
+        0x19, 0x11, 0x15, 0x11, 0x13, 
+        /* [  */
+        0x1f, 0x11, 0x11, 0x00, 0x00, 
+        /* \  */
+        0x01, 0x02, 0x04, 0x08, 0x10, 
+        /* ]  */
+        0x00, 0x11, 0x11, 0x1f, 0x00, 
+        /* ^  */
+        0x04, 0x02, 0x01, 0x02, 0x04, 
+        /* _  */
+        0x10, 0x10, 0x10, 0x10, 0x10, 
+        /* `  */
+        0x00, 0x01, 0x02, 0x04, 0x00, 
+        /* a  */
+        0x08, 0x15, 0x15, 0x15, 0x1e, 
+        /* b  */
+        0x1f, 0x14, 0x12, 0x12, 0x0c, 
+        /* c  */
+        0x0e, 0x11, 0x11, 0x11, 0x08, 
+        /* d  */
+        0x08, 0x14, 0x14, 0x10, 0x1f, 
+        /* e  */
+        0x0e, 0x15, 0x15, 0x15, 0x06, 
+        /* f  */
+        0x08, 0x1e, 0x09, 0x01, 0x02, 
+        /* g  */
+        0x02, 0x15, 0x15, 0x15, 0x0f, 
+        /* h  */
+        0x1f, 0x08, 0x04, 0x04, 0x18, 
+        /* i  */
+        0x00, 0x14, 0x1d, 0x10, 0x00, 
+        /* j  */
+        0x08, 0x10, 0x14, 0x0d, 0x00, 
+        /* k  */
+        0x1f, 0x04, 0x0a, 0x11, 0x00, 
+        /* l  */
+        0x00, 0x11, 0x1f, 0x10, 0x00, 
+        /* m  */
+        0x1f, 0x01, 0x06, 0x01, 0x1e, 
+        /* n  */
+        0x1f, 0x02, 0x01, 0x01, 0x1e, 
+        /* o  */
+        0x0e, 0x11, 0x11, 0x11, 0x0e, 
+        /* p  */
+        0x1f, 0x05, 0x05, 0x05, 0x02, 
+        /* q  */
+        0x02, 0x05, 0x05, 0x06, 0x1f, 
+        /* r  */
+        0x1f, 0x02, 0x01, 0x01, 0x02, 
+        /* s  */
+        0x12, 0x15, 0x15, 0x15, 0x08, 
+        /* t  */
+        0x02, 0x0f, 0x12, 0x10, 0x08, 
+        /* u  */
+        0x0f, 0x10, 0x10, 0x08, 0x1f, 
+        /* v  */
+        0x07, 0x08, 0x10, 0x08, 0x07, 
+        /* w  */
+        0x0f, 0x10, 0x0e, 0x10, 0x0f, 
+        /* x  */
+        0x11, 0x0a, 0x04, 0x0a, 0x11, 
+        /* y  */
+        0x03, 0x14, 0x14, 0x14, 0x0f, 
+        /* z  */
+        0x11, 0x19, 0x15, 0x13, 0x11, 
+        /* {  */
+        0x04, 0x0e, 0x11, 0x11, 0x00, 
+        /* |  */
+        0x00, 0x00, 0x1f, 0x00, 0x00, 
+        /* }  */
+        0x00, 0x11, 0x1b, 0x04, 0x00, 
+        /* ~  */
+        0x02, 0x01, 0x02, 0x04, 0x02, 
+    }
+};
+#endif  /* FONT5X5_1_C_H_  */
@@ -0,0 +1,186 @@
+/** @file    font5x7_2_c.h
+    @author  fontgen
+    @date    17 Oct 2026
+
+    @defgroup font5x7_2_c  This is a 5x7 font with uppercase, digits, and some symbols.
+ M.P. Hayes 2 Sep 2010
+
+*/
+
+#ifndef FONT5X7_2_C_H_
+#define FONT5X7_2_C_H_
+
+#define FONT5X7_2_C_WIDTH 5
+#define FONT5X7_2_C_HEIGHT 7
+#define FONT5X7_2_C_OFFSET 32
+#define FONT5X7_2_C_SIZE 71
+
+#ifndef FONT_WIDTH
+#define FONT_WIDTH 5
+#endif
+#ifndef FONT_HEIGHT
+#define FONT_HEIGHT 7
+#endif
+#ifndef FONT_OFFSET
+#define FONT_OFFSET 32
+#endif
+#ifndef FONT_SIZE_MAX
+#define FONT_SIZE_MAX 71
+#endif
+#include "font.h"
+
+static font_t font5x7_2_c =
+{
+    .flags = 2, /* (columns)  */
+    .width = 5,
+    .height = 7,
+    .offset = 32,
+    .size = 71,
+    .bytes = 5,
+    .data =
+    {
+        /*    */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* !  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* "  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* #  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* $  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* %  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* &  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* '  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* (  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* )  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* *  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* +  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* ,  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* -  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* .  */
+        0x00, 0x00, 0x08, 0x00, 0x00, 
+        /* /  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* 0  */
+        0x3e, 0x51, 0x49, 0x45, 0x3e, 
+        /* 1  */
+        0x00, 0x42, 0x7f, 0x40, 0x00, 
+        /* 2  */
+        0x42, 0x61, 0x51, 0x49, 0x46, 
+        /* 3  */
+        0x21, 0x41, 0x45, 0x4b, 0x31, 
+        /* 4  */
+        0x18, 0x14, 0x12, 0x7f, 0x10, 
+        /* 5  */
+        0x27, 0x45, 0x45, 0x45, 0x39, 
+        /* 6  */
+        0x3c, 0x4a, 0x49, 0x49, 0x30, 
+        /* 7  */
+        0x01, 0x01, 0x79, 0x05, 0x03, 
+        /* 8  */
+        0x37, 0x49, 0x49, 0x49, 0x36, 
+        /* 9  */
+        0x06, 0x49, 0x49, 0x29, 0x1e, 
+        /* :  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* ;  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* <  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* =  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* >  */
+        0x41, 0x22, 0x14, 0x08, 0x00, 
+        /* ?  */
+        0x02, 0x01, 0x51, 0x09, 0x06, 
+        /* @  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* A  */
+        0x7e, 0x11, 0x11, 0x11, 0x7e, 
+        /* B  */
+        0x41, 0x7f, 0x49, 0x49, 0x36, 
+        /* C  */
+        0x3e, 0x41, 0x41, 0x41, 0x22, 
+        /* D  */
+        0x41, 0x7f, 0x41, 0x41, 0x3e, 
+        /* E  */
+        0x7f, 0x49, 0x49, 0x49, 0x49, 
+        /* F  */
+        0x7f, 0x09, 0x09, 0x09, 0x01, 
+        /* G  */
+        0x3e, 0x41, 0x41, 0x49, 0x7a, 
+        /* H  */
+        0x7f, 0x08, 0x08, 0x08, 0x7f, 
+        /* I  */
+        0x00, 0x41, 0x7f, 0x41, 0x00, 
+        /* J  */
+        0x20, 0x40, 0x41, 0x3f, 0x01, 
+        /* K  */
+        0x7f, 0x08, 0x14, 0x22, 0x41, 
+        /* L  */
+        0x7f, 0x40, 0x40, 0x40, 0x40, 
+        /* M  */
+        0x7f, 0x02, 0x0c, 0x02, 0x7f, 
+        /* N  */
+        0x7f, 0x06, 0x08, 0x30, 0x7f, 
+        /* O  */
+        0x3e, 0x41, 0x41, 0x41, 0x3e, 
+        /* P  */
+        0x7f, 0x09, 0x09, 0x09, 0x06, 
+        /* Q  */
+        0x7e, 0x41, 0x51, 0x21, 0x5e, 
+        /* R  */
+        0x7f, 0x09, 0x19, 0x29, 0x46, 
+        /* S  */
+        0x26, 0x49, 0x49, 0x49, 0x32, 
+        /* T  */
+        0x01, 0x01, 0x7f, 0x01, 0x01, 
+        /* U  */
+        0x3f, 0x40, 0x40, 0x40, 0x3f, 
+        /* V  */
+        0x1f, 0x20, 0x40, 0x20, 0x1f, 
+        /* W  */
+        0x7f, 0x20, 0x18, 0x20, 0x7f, 
+        /* X  */
+        0x63, 0x14, 0x08, 0x14, 0x63, 
+        /* Y  */
+        0x07, 0x08, 0x70, 0x08, 0x07, 
+        /* Z  */
+        0x61, 0x51, 0x49, 0x45, 0x43, 
+        /* [  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* \  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* ]  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* ^  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* _  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* `  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* a  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* b  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* c  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* d  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* e  */
+        0x00, 0x00, 0x00, 0x00, 0x00, 
+        /* f  */
+        0x7e, 0x11, 0x11, 0x11, 0x12, 
+    }
+};
+#endif  /* FONT5X7_2_C_H_  */
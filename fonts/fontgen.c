@@ -24,6 +24,8 @@ typedef struct
     uint8_t size;
     uint8_t bytes;
     uint8_t interlaced;
+    uint8_t columns;
+    char *subset;
     uint8_t *data;
 } font_t;
 
@@ -310,6 +312,60 @@ static void font_print_1 (font_t *font, uint8_t symbol)
 }
 
 
+/* Print a symbol one byte per column, bit 0 the top row.  */
+static void font_print_columns_1 (font_t *font, uint8_t symbol)
+{
+    int x;
+    int y;
+
+    for (x = 0; x < font->width; x++)
+    {
+        uint8_t column = 0;
+
+        for (y = 0; y < font->height; y++)
+        {
+            int bit;
+
+            bit = y * font->width + x;
+            if (font->data[symbol * font->bytes + bit / CHAR_BIT] 
+                & (1 << (bit % CHAR_BIT)))
+                column |= 1 << y;
+        }
+        printf ("0x%02x, ", column);
+    }
+    fputs ("\n", stdout);
+}
+
+
+/* Find the symbols to print, in ascending order, returning how many.  */
+static int font_symbols (font_t *font, uint8_t *symbols)
+{
+    int num = 0;
+    int i;
+
+    if (!font->subset)
+    {
+        for (i = font->offset; i < font->size + font->offset; i++)
+            symbols[num++] = i;
+        return num;
+    }
+
+    for (i = 0; i <= FONT_SIZE_MAX; i++)
+    {
+        if (i == 0 || !strchr (font->subset, i))
+            continue;
+
+        if (i < font->offset || i >= font->size + font->offset)
+        {
+            fprintf (stderr, "Symbol %c not in font\n", i);
+            continue;
+        }
+        symbols[num++] = i;
+    }
+    return num;
+}
+
+
 static void font_rotate (font_t *font, font_t *rotate_font)
 {
     int i;
@@ -346,12 +402,25 @@ static void font_rotate (font_t *font, font_t *rotate_font)
 static void font_print (font_t *font)
 {
     int i;
+    int num;
     uint8_t bytes_per_char;
+    uint8_t flags;
+    uint8_t symbols[FONT_SIZE_MAX + 1];
     time_t now;
     char name_upper[128];
     char timestr[32];
 
     bytes_per_char = (font->width * font->height + CHAR_BIT - 1) / CHAR_BIT;
+    flags = 1;
+    if (font->columns)
+    {
+        bytes_per_char = font->width;
+        flags = 2;
+    }
+    if (font->subset)
+        flags |= 4;
+
+    num = font_symbols (font, symbols);
 
     for (i= 0; font->name[i]; i++)
         name_upper[i] = toupper (font->name[i]);
@@ -364,13 +433,20 @@ static void font_print (font_t *font)
     printf ("    @author  fontgen\n");
     printf ("    @date    %s\n\n", timestr);
     printf ("    @defgroup %s %s\n", font->name, font->comment);
+    if (font->subset)
+    {
+        printf ("    Subset: ");
+        for (i = 0; i < num; i++)
+            fputc (symbols[i], stdout);
+        printf ("\n");
+    }
     printf ("*/\n\n");
     printf ("#ifndef %s_H_\n", name_upper);
     printf ("#define %s_H_\n\n", name_upper);
     printf ("#define %s_WIDTH %d\n", name_upper, font->width);
     printf ("#define %s_HEIGHT %d\n", name_upper, font->height);
     printf ("#define %s_OFFSET %d\n", name_upper, font->offset);
-    printf ("#define %s_SIZE %d\n\n", name_upper, font->size);
+    printf ("#define %s_SIZE %d\n\n", name_upper, num);
 
     printf ("#ifndef FONT_WIDTH\n#define FONT_WIDTH %d\n#endif\n",
             font->width);
@@ -379,27 +455,40 @@ static void font_print (font_t *font)
     printf ("#ifndef FONT_OFFSET\n#define FONT_OFFSET %d\n#endif\n",
             font->offset);
     printf ("#ifndef FONT_SIZE_MAX\n#define FONT_SIZE_MAX %d\n#endif\n",
-            font->size);
+            num);
 
     printf ("#include \"font.h\"\n\n");
     printf ("static font_t %s =\n{\n", font->name);    
 
-    printf ("    .flags = 1, /* (packed)  */\n");
+    printf ("    .flags = %d, /* (%s%s)  */\n", flags,
+            font->columns ? "columns" : "packed",
+            font->subset ? ", subset" : "");
     printf ("    .width = %d,\n", font->width);
     printf ("    .height = %d,\n", font->height);
     printf ("    .offset = %d,\n", font->offset);
-    printf ("    .size = %d,\n", font->size);
+    printf ("    .size = %d,\n", num);
     printf ("    .bytes = %d,\n", bytes_per_char);
     printf ("    .data =\n    {\n");
 
-    for (i = font->offset; i < font->size + font->offset; i++)
+    if (font->subset)
+    {
+        printf ("        /* symbols  */\n        ");
+        for (i = 0; i < num; i++)
+            printf ("0x%02x, ", symbols[i]);
+        fputs ("\n", stdout);
+    }
+
+    for (i = 0; i < num; i++)
     {
-        if (i < 32)
-            printf ("        /* \\%o  */\n        ", i);
+        if (symbols[i] < 32)
+            printf ("        /* \\%o  */\n        ", symbols[i]);
         else
-            printf ("        /* %c  */\n        ", i);
+            printf ("        /* %c  */\n        ", symbols[i]);
 
-        font_print_1 (font, i);
+        if (font->columns)
+            font_print_columns_1 (font, symbols[i]);
+        else
+            font_print_1 (font, symbols[i]);
     }
     printf ("    }\n};\n#endif  /* %s_H_  */\n", name_upper);
 }
@@ -467,9 +556,13 @@ int main (int argc, char **argv)
     if (ret)
         return ret;
 
+    font.columns = 0;
+    font.subset = 0;
+
     if (argc < 2)
     {
-        fprintf (stderr, "Usage: fontgen fontname\n");
+        fprintf (stderr, "Usage: fontgen fontname [--zoom n] [--rotate] "
+                 "[--columns] [--subset chars] [--ascii]\n");
         return 1;
     }
     strcpy (font.name, argv[1]);
@@ -500,6 +593,27 @@ int main (int argc, char **argv)
         font = rotate_font;
     }
 
+    if (argc > 1 && !strcmp (argv[1], "--columns"))
+    {
+        argc -= 1;
+        argv += 1;
+
+        if (font.height > CHAR_BIT || font.interlaced)
+        {
+            fprintf (stderr, "Column-major fonts must be at most %d high"
+                     " and not interlaced\n", CHAR_BIT);
+            return 1;
+        }
+        font.columns = 1;
+    }
+
+    if (argc > 2 && !strcmp (argv[1], "--subset"))
+    {
+        font.subset = argv[2];
+        argc -= 2;
+        argv += 2;
+    }
+
     if (argc > 1 && !strcmp (argv[1], "--ascii"))
         font_draw (&font);
     else
@@ -31,86 +31,130 @@ typedef struct {
     Rotation_t rotation;
 } Arrow_t;
 
-struct Node_s{
-    struct Node_s* next_node;
-    struct Node_s* prev_node;
-    Arrow_t* arrow;
-};
+/**
+ * @brief Fewest rows between two arrows on the screen, not counting their own rows.
+ */
+#define ARROW_DISTANCE 4
+
+/**
+ * @brief Number of arrows a queue can hold. Must be a power of two so
+ *        the ring indices can be wrapped with a mask.
+ */
+#ifndef ARROW_QUEUE_SIZE
+#define ARROW_QUEUE_SIZE 16
+#endif
 
-typedef struct Node_s Node_t;
+#if (ARROW_QUEUE_SIZE & (ARROW_QUEUE_SIZE - 1)) || ARROW_QUEUE_SIZE > 128
+#error ARROW_QUEUE_SIZE must be a power of two no larger than 128
+#endif
 
+/**
+ * @brief Fixed-capacity ring buffer of arrows stored by value.
+ *        head and tail are free-running counters; the number of queued
+ *        arrows is tail - head.
+ */
 typedef struct {
-    Node_t* head;
-    Node_t* tail;
+    Arrow_t arrows[ARROW_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t tail;
 } ArrowQueue_t;
 
 /**
- * @brief Move all incomming/outgoing arrows by one position at once.
+ * @brief Pops an arrow off the head of the queue. Assumes that there is at least one arrow in the queue.
  * 
- * @param queue The queue of arrows to be moved.
- * @param direction Direction_t enum value for the direction of movement.
+ * @param queue ArrowQueue_t to be popped.
+ * @return Arrow_t copy of the arrow from the head of the queue.
  */
-void move_arrows(ArrowQueue_t* queue, Direction_t directon);
+Arrow_t queue_pop(ArrowQueue_t* queue);
 
 /**
- * @brief Pops an arrow off the head of the queue. Assumes that there is at least one node in the queue.
+ * @brief Returns the arrow at the head of the queue without removing it.
  * 
- * @param queue ArrowQueue_t to be popped.
- * @return Arrow_t* the Arrow pointer from the head of the queue.
+ * @param queue ArrowQueue_t to be peeked.
+ * @return Arrow_t* pointer to the head arrow, or NULL if the queue is empty.
  */
-Arrow_t* queue_pop(ArrowQueue_t* queue);
+Arrow_t* queue_peek(ArrowQueue_t* queue);
 
 /**
- * @brief Clears the queue of all nodes/arrows and frees all memory.
+ * @brief Returns an arrow in the queue by its position from the head.
+ * 
+ * @param queue ArrowQueue_t to be read.
+ * @param index Position from the head, which must be less than queue_length.
+ * @return Arrow_t* pointer to the arrow.
+ */
+Arrow_t* queue_get(ArrowQueue_t* queue, uint8_t index);
+
+/**
+ * @brief Clears the queue of all arrows.
  * 
  * @param queue The ArrowQueue to be cleared.
  */
 void queue_clear(ArrowQueue_t* queue);
 
 /**
- * @brief Appends an arrow to the end of a queue.
+ * @brief Appends a copy of an arrow to the end of a queue.
  * 
  * @param queue ArrowQueue to be appened to.
- * @param arrow Arrow pointer to be added to the queue.
+ * @param arrow Arrow to be copied into the queue.
+ * @return true The arrow was added.
+ * @return false The queue is full and the arrow was not added.
+ */
+bool queue_append(ArrowQueue_t* queue, Arrow_t* arrow);
+
+/**
+ * @brief Returns the number of arrows in a queue.
+ * 
+ * @param queue The ArrowQueue to be measured.
+ * @return uint8_t number of queued arrows.
+ */
+uint8_t queue_length(ArrowQueue_t* queue);
+
+/**
+ * @brief Returns true if the queue holds no arrows.
+ * 
+ * @param queue The ArrowQueue to be tested.
+ * @return true The queue is empty.
+ * @return false There is at least one arrow in the queue.
  */
-void queue_append(ArrowQueue_t* queue, Arrow_t* arrow);
+bool queue_is_empty(ArrowQueue_t* queue);
 
 /**
- * @brief Moves an arrow to the left and updates diplay.
+ * @brief Returns true if no more arrows can be appended to the queue.
+ * 
+ * @param queue The ArrowQueue to be tested.
+ * @return true The queue is full.
+ * @return false There is space for at least one more arrow.
+ */
+bool queue_is_full(ArrowQueue_t* queue);
+
+/**
+ * @brief Moves an arrow to the left.
  * 
  * @param arrow Arrow to be shifted to the left by one position.
  */
 void move_arrow_left(Arrow_t* arrow);
 
 /**
- * @brief Moves an arrow to the right and updates diplay.
+ * @brief Moves an arrow to the right.
  * 
  * @param arrow Arrow to be shifted to the right by one position.
  */
 void move_arrow_right(Arrow_t* arrow);
 
 /**
- * @brief Rotates an arrow clockwise and updates diplay
+ * @brief Rotates an arrow clockwise
  * 
  * @param arrow Arrow to be rotated.
  */
 void rotate_clockwise(Arrow_t* arrow);
 
 /**
- * @brief Rotates an arrow anticlockwise and updates diplay.
+ * @brief Rotates an arrow anticlockwise.
  * 
  * @param arrow Arrow to be rotated.
  */
 void rotate_anticlockwise(Arrow_t* arrow);
 
-/**
- * @brief Updates the arrows position diplayed on the screen.
- * 
- * @param arrow Arrow to be updated on the screen.
- * @param state bool for being on or off.
- */
-void update_arrow(Arrow_t* arrow, uint8_t state);
-
 /**
  * @brief Equates if two arrows are equal.
  * 
@@ -121,31 +165,4 @@ void update_arrow(Arrow_t* arrow, uint8_t state);
  */
 bool is_arrow_equal(Arrow_t* arrow1, Arrow_t* arrow2);
 
-/**
- * @brief Returns True if the player missed the arrow.
- * 
- * @param player The players arrow
- * @param arrow The arrow that might've been missed.
- * @return true The player has missed this arrow.
- * @return false The arrow has yet to pass the player.
- */
-bool arrow_missed(Arrow_t* player, Arrow_t* arrow);
-
-/**
- * @brief Returns a new arrow initilised to the provided values and allocated the correct memory.
- * 
- * @param x x-position.
- * @param y y-position.
- * @param rotation Rotation_t for the arrow rotation.
- * @return Arrow_t* pointer to the newly created arrow.
- */
-Arrow_t* new_arrow(uint8_t x, uint8_t y, Rotation_t rotation);
-
-/**
- * @brief Deletes an arrow from the display and frees the memory the arrow was allocated.
- * 
- * @param arrow Arrow to be deleted.
- */
-void delete_arrow(Arrow_t* arrow);
-
 #endif
\ No newline at end of file
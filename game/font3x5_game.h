@@ -0,0 +1,73 @@
+/** @file    font3x5_game.h
+    @author  fontgen
+    @date    17 Oct 2026
+
+    @defgroup font3x5_game  This is a tiny 3x5 font with uppercase, digits, and symbols only.
+ M.P. Hayes 2 Sep 2010
+
+    Subset:  (=DEILNOSUWY
+*/
+
+#ifndef FONT3X5_GAME_H_
+#define FONT3X5_GAME_H_
+
+#define FONT3X5_GAME_WIDTH 3
+#define FONT3X5_GAME_HEIGHT 5
+#define FONT3X5_GAME_OFFSET 32
+#define FONT3X5_GAME_SIZE 13
+
+#ifndef FONT_WIDTH
+#define FONT_WIDTH 3
+#endif
+#ifndef FONT_HEIGHT
+#define FONT_HEIGHT 5
+#endif
+#ifndef FONT_OFFSET
+#define FONT_OFFSET 32
+#endif
+#ifndef FONT_SIZE_MAX
+#define FONT_SIZE_MAX 13
+#endif
+#include "font.h"
+
+static font_t font3x5_game =
+{
+    .flags = 6, /* (columns, subset)  */
+    .width = 3,
+    .height = 5,
+    .offset = 32,
+    .size = 13,
+    .bytes = 3,
+    .data =
+    {
+        /* symbols  */
+        0x20, 0x28, 0x3d, 0x44, 0x45, 0x49, 0x4c, 0x4e, 0x4f, 0x53, 0x55, 0x57, 0x59, 
+        /*    */
+        0x00, 0x00, 0x00, 
+        /* (  */
+        0x0e, 0x11, 0x00, 
+        /* =  */
+        0x0a, 0x0a, 0x0a, 
+        /* D  */
+        0x1f, 0x11, 0x0e, 
+        /* E  */
+        0x1f, 0x15, 0x15, 
+        /* I  */
+        0x11, 0x1f, 0x11, 
+        /* L  */
+        0x1f, 0x10, 0x10, 
+        /* N  */
+        0x1f, 0x01, 0x1f, 
+        /* O  */
+        0x1f, 0x11, 0x1f, 
+        /* S  */
+        0x16, 0x15, 0x09, 
+        /* U  */
+        0x1f, 0x10, 0x1f, 
+        /* W  */
+        0x1f, 0x0c, 0x1f, 
+        /* Y  */
+        0x03, 0x1c, 0x03, 
+    }
+};
+#endif  /* FONT3X5_GAME_H_  */
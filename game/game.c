@@ -8,8 +8,11 @@
  */
 #include "system.h"
 #include "arrow.h"
+#include "lanes.h"
 #include "tinygl.h"
-#include "pacer.h"
+#include "display.h"
+#include "task.h"
+#include "sprite.h"
 #include "game_setup.h"
 #include "player.h"
 #include "level.h"
@@ -17,49 +20,96 @@
 #include <stdio.h>
 #include "transmission.h"
 #include "screen_text.h"
+#include "stats.h"
 
-#define PACER_RATE 1000
-#define DISPLAY_TASK_RATE 300
-#define CHECK_PLAYER_TASK 10
-#define GET_INPUT_TASK 250
-#define TRANSMITTION_TASK 20
+#define DISPLAY_TASK_RATE 60
+#define DISPLAY_REFRESH_RATE 1000
+#define CHECK_PLAYER_TASK_RATE 10
+#define GET_INPUT_TASK_RATE 250
+#define TRANSMITTION_TASK_RATE 20
 
+void display_task(void* data);
+void get_input_task(void* data);
+void move_arrows_task(void* data);
+void transmission_task(void* data);
+void check_player_task(void* data);
+void game_over_task(void);
 
-ArrowQueue_t outgoing_queue = {.head = NULL, .tail = NULL};
-ArrowQueue_t incoming_queue = {.head = NULL, .tail = NULL};
+// Tasks in priority order (highest first).
+enum {DISPLAY_TASK, GET_INPUT_TASK, MOVE_ARROWS_TASK, TRANSMITTION_TASK, CHECK_PLAYER_TASK, NUM_TASKS};
+
+static task_t tasks[NUM_TASKS] =
+{
+    [DISPLAY_TASK] = {.func = display_task, .period = TASK_RATE / DISPLAY_TASK_RATE, TASK_PROFILE("display")},
+    [GET_INPUT_TASK] = {.func = get_input_task, .period = TASK_RATE / GET_INPUT_TASK_RATE, TASK_PROFILE("get_input")},
+    [MOVE_ARROWS_TASK] = {.func = move_arrows_task, .period = 0, TASK_PROFILE("move_arrows")},
+    [TRANSMITTION_TASK] = {.func = transmission_task, .period = TASK_RATE / TRANSMITTION_TASK_RATE, TASK_PROFILE("transmission")},
+    [CHECK_PLAYER_TASK] = {.func = check_player_task, .period = TASK_RATE / CHECK_PLAYER_TASK_RATE, TASK_PROFILE("check_player")},
+};
+
+// Arrows on the screen, and arrows waiting to be sent or to come on to the screen.
+ArrowLanes_t outgoing_lanes;
+ArrowLanes_t incoming_lanes;
+ArrowQueue_t outgoing_queue = {.head = 0, .tail = 0};
+ArrowQueue_t incoming_queue = {.head = 0, .tail = 0};
 
 // initialise player as global variable
 uint8_t player_num;
 Player_t player;
 Level_t game_level;
 bool gameover = false;
+// False while waiting for a game to start, with the end screen showing after a game.
+bool playing = false;
+
+/**
+ * @brief Sets the period of the arrow movement task from the current level's arrow speed.
+ *        This is the only place the period is divided out, so it only happens on a level change.
+ * 
+ */
+void arrow_speed_update(void)
+{
+    task_period_set(&tasks[MOVE_ARROWS_TASK], TASK_RATE / game_level.arrow_speed);
+}
 
 /**
- * @brief Sets up the game and decides player number.
+ * @brief Sets up a new game once the player number has been decided.
  * 
+ * @param num The player number, PLAYER_ONE or PLAYER_TWO.
  */
-void game_setup(void)
+void game_setup(uint8_t num)
 {
-    player_num = game_init();
+    player_num = num;
     game_level = level_init();
     player = player_init(player_num, &game_level);
+    arrow_speed_update();
+    lanes_clear(&incoming_lanes);
+    lanes_clear(&outgoing_lanes);
+    queue_clear(&incoming_queue);
+    queue_clear(&outgoing_queue);
+
+    display_win_stop();
+    task_period_set(&tasks[DISPLAY_TASK], TASK_RATE / DISPLAY_TASK_RATE);
+    gameover = false;
+    playing = true;
 }
 
 /**
  * @brief Checks payer data for let the game know when to move to a new level, sets the blue LED light and when the game is over.
  * 
  */
-void check_player_task(void)
+void check_player(void)
 {
     if (player.is_sender) {
-        if (player.moves <= 0 && outgoing_queue.head == NULL) {
+        if (player.moves <= 0 && queue_is_empty(&outgoing_queue) && lanes_is_empty(&outgoing_lanes)) {
             level_update(&game_level);
             player_update(&player, game_level.num_moves);  
+            arrow_speed_update();
         }
     } else {
-        if (player.moves <= 0 && incoming_queue.tail == NULL) {
+        if (player.moves <= 0 && queue_is_empty(&incoming_queue) && lanes_is_empty(&incoming_lanes)) {
             level_update(&game_level);
             player_update(&player, game_level.num_moves);
+            arrow_speed_update();
         }
     }
 
@@ -69,128 +119,213 @@ void check_player_task(void)
     }
 }
 
+/**
+ * @brief Composites the player's arrow and every queued arrow into the display.
+ * 
+ */
+void draw_frame(void)
+{
+    sprite_frame_clear();
+    sprite_add_lanes(&outgoing_lanes);
+    sprite_add_lanes(&incoming_lanes);
+    sprite_add(&player.player_arrow);
+    sprite_frame_show();
+}
+
+/**
+ * @brief Draws a new frame into the back buffer and shows it; the timer interrupt refreshes the display.
+ *        Between games this scrolls the end screen text instead.
+ * 
+ */
+void display_task(__unused__ void* data)
+{
+    if (!playing) {
+        display_win_update();
+        return;
+    }
+    draw_frame();
+    display_swap();
+}
+
 /**
  * @brief Handles the inputs queries for the game. Adds a new arrow to the outgoin queue if NAVSWITCH is pushed and the player is sender.
  * 
  */
-void get_input_task(void)
+void get_input_task(__unused__ void* data)
 {
-    bool btn_pressed = player_input(&player);
-    if (btn_pressed) {
-        Arrow_t* player_arrow = &player.player_arrow;
-        Arrow_t* arrow = new_arrow(player_arrow->x, player_arrow->y, player_arrow->rotation);
-        queue_append(&outgoing_queue, arrow);
+    bool btn_pressed;
+
+    if (!playing) {
+        input_flush();
+        return;
+    }
+
+    btn_pressed = player_input(&player);
+    if (btn_pressed && !lanes_add(&outgoing_lanes, &player.player_arrow)) {
+        // The last arrow is still too close so give the move back to the player.
+        player.moves++;
     }
 }
 
 /**
  * @brief Checks if incoming arrows have been missed or matched correctly.
+ *        A match is one AND of the player's lane and rotation with the player's row,
+ *        and every arrow that has passed that row is missed.
  * 
  */
 void check_arrow_match(void)
 {
-    Node_t* incoming_head = incoming_queue.head;
+    uint8_t missed;
 
-    if (!player.is_sender && incoming_head != NULL) {
-        Arrow_t* incoming_arrow = incoming_head->arrow;
+    if (player.is_sender) {
+        return;
+    }
 
-        if (is_arrow_equal(&player.player_arrow, incoming_arrow)) {
-            incoming_arrow = queue_pop(&incoming_queue);
-            delete_arrow(incoming_arrow);
-            dec_moves(&player);
+    if (lanes_remove(&incoming_lanes, &player.player_arrow)) {
+        dec_moves(&player);
+    }
 
-        } else if (arrow_missed(&player.player_arrow, incoming_arrow)) {
-            incoming_arrow = queue_pop(&incoming_queue);
-            delete_arrow(incoming_arrow);
-            update_lives(&player);
-            dec_moves(&player);
-        }
+    missed = lanes_remove_rows(&incoming_lanes, BIT(player.player_arrow.y) - 1, NULL);
+    for (; missed && player.lives; missed--) {
+        update_lives(&player);
+        dec_moves(&player);
     }
 }
 
 /**
- * @brief Main transmission task for sending and receiving arrows.
+ * @brief Main transmission task. Handles one received message, then sends the next arrow if the player is sender.
+ *        Between games it watches for the button or the other board starting the next game.
  * 
  */
-void transmission_task (void)
+void transmission_task(__unused__ void* data)
 {
-    if (is_gameover()) {
-        gameover = true;
-    } else if (player.is_sender) {
-        sender_transmission(&outgoing_queue);
-    } else {
-        receiver_transmission(&incoming_queue);
+    Arrow_t arrow;
+    Message_t message = receive_message(&arrow);
+
+    if (!playing) {
+        uint8_t num = game_start_poll(message);
+
+        if (num) {
+            game_setup(num);
+        }
+        return;
+    }
+
+    switch (message) {
+    case MESSAGE_GAMEOVER:
+        game_over_task();
+        return;
+
+    case MESSAGE_START:
+        // Both players pressed the button together, or the other board
+        // missed the end of this game and has started the next.
+        if (game_start_received() == PLAYER_TWO) {
+            game_setup(PLAYER_TWO);
+        }
+        return;
+
+    case MESSAGE_START_ACK:
+        game_start_settled();
+        return;
+
+    case MESSAGE_ARROW:
+        game_start_settled();
+        if (!player.is_sender && !queue_append(&incoming_queue, &arrow)) {
+            // No room for the received arrow so count it as played.
+            dec_moves(&player);
+        }
+        break;
+
+    default:
+        break;
     }
 
+    game_start_update();
+    if (player.is_sender) {
+        sender_transmission(&outgoing_queue);
+    }
 }
 
 /**
  * @brief Moves all the arrows in the outgoing and incoming queues.
  * 
  */
-void move_arrows_task(void)
+void move_arrows_task(__unused__ void* data)
 {
+    if (!playing) {
+        return;
+    }
+
     if (player.is_sender) {
-        move_arrows(&outgoing_queue, AWAY);
+        // Arrows that leave the top of the screen wait in the queue to be sent.
+        LaneRows_t off_screen = ~(LaneRows_t)(BIT(LANES_TOP_ROW) - 1);
+
+        lanes_advance(&outgoing_lanes, AWAY);
+        lanes_remove_rows(&outgoing_lanes, off_screen, &outgoing_queue);
+        // No room in the queue so the rest will never be sent; give the moves back to the player.
+        player.moves += lanes_remove_rows(&outgoing_lanes, off_screen, NULL);
     } else {
-        move_arrows(&incoming_queue, TOWARDS);
+        // The next received arrow comes on once it is far enough behind the last.
+        Arrow_t* arrow = queue_peek(&incoming_queue);
+
+        lanes_advance(&incoming_lanes, TOWARDS);
+        if (arrow != NULL && lanes_add(&incoming_lanes, arrow)) {
+            queue_pop(&incoming_queue);
+        }
     }
-    update_arrow(&(player.player_arrow), 1);
 }
 
 /**
- * @brief When the game ends, this function is called to reset the game so the players can play again.
+ * @brief When the game ends, this function is called to record the result and show the end screen.
+ *        The tasks keep running, so either player can start the next game straight away.
  * 
  */
 void game_over_task(void)
 {
     gameover = false;
+    playing = false;
+    stats_game_over(player.lives > 0, game_level.level);
     display_win(player.lives>0);
-    game_setup();
-    queue_clear(&incoming_queue);
-    queue_clear(&outgoing_queue);
+    task_period_set(&tasks[DISPLAY_TASK], TASK_RATE / TEXT_UPDATE_RATE);
 }
 
 /**
- * @brief Main loop and round robin scheduler
+ * @brief Checks the player and incoming arrows, and resets the game once it is over.
+ * 
+ */
+void check_player_task(__unused__ void* data)
+{
+    if (!playing) {
+        return;
+    }
+
+    check_player();
+    check_arrow_match();
+
+    if (gameover) {
+        game_over_task();
+    }
+}
+
+/**
+ * @brief Sets up the game and hands over to the task scheduler.
  * 
  * @return int 
  */
 int main (void)
 {
     system_init ();
+    stats_init();
     input_init();
-    pacer_init(PACER_RATE);
-    tinygl_init(PACER_RATE);
-    game_setup();
-
-    int tick = 0;
-
-    while (!gameover)
-    {
-        pacer_wait();
-        
-        if (tick % (PACER_RATE / DISPLAY_TASK_RATE) == 0) {
-            tinygl_update();
-        }
-        if (tick % (PACER_RATE / GET_INPUT_TASK) == 0) {
-            get_input_task();
-        }
-        if (tick % (PACER_RATE / game_level.arrow_speed) == 0) {
-            move_arrows_task();
-        }
-        if (tick % (PACER_RATE / TRANSMITTION_TASK) == 0) {
-            transmission_task();
-        }
+    tinygl_init(TEXT_UPDATE_RATE);
+    display_double_buffer_set(true);
+    display_refresh_start(DISPLAY_REFRESH_RATE);
+    game_init();
 
-        if (tick % (PACER_RATE / CHECK_PLAYER_TASK) == 0) {
-            check_player_task();
-            check_arrow_match();
-        }
-        if (gameover) {
-            game_over_task();
-        }
+    // The arrow task runs idle until the first game, so give it a period.
+    game_level = level_init();
+    arrow_speed_update();
 
-        tick++;
-    }
+    task_schedule(tasks, NUM_TASKS);
+    return 0;
 }
@@ -9,29 +9,112 @@
 
 #include "button.h"
 #include "ir_uart.h"
+#include "timer.h"
 #include "game_setup.h"
+#include "transmission.h"
 #include <stdint.h>
+#include <stdbool.h>
 
-#define PLAYER_ONE 1
-#define PLAYER_TWO 2
+// Multiplier for a 16-bit Fibonacci hash of the timer, whose top bits are the nonce.
+#define START_NONCE_HASH 40503u
+#define START_NONCE_SHIFT 13
+// How long player 1 waits for START_ACK before sending START again.
+#define START_RESEND_TICKS ((timer_tick_t)(TIMER_RATE / 4))
+
+static uint8_t start_nonce;
+static timer_tick_t start_sent;
+// True from pressing the button to start as player 1 until player 2 has answered.
+static bool start_contested = false;
 
 /**
- * @brief Initialises the game. First player to press the button is player 1.
+ * @brief Sends START with a fresh nonce. The nonce comes from the time,
+ *        which differs between the boards as they were not powered up together.
  * 
  */
-uint8_t game_init (void)
+static void start_send(void)
+{
+    start_sent = timer_get();
+    start_nonce = (uint16_t)(start_sent * START_NONCE_HASH) >> START_NONCE_SHIFT;
+    transmit_start(start_nonce);
+}
+
+/**
+ * @brief Initialises the button and IR link used to start a game.
+ * 
+ */
+void game_init (void)
 {
     button_init();
     ir_uart_init();
+}
 
-    while (1) {
-        button_update ();
-        if (ir_uart_read_ready_p() && ir_uart_getc() == PLAYER_TWO) {
-            return PLAYER_TWO;
-        }
-        if (button_push_event_p(0)) {
-            ir_uart_putc(PLAYER_TWO);
-            return PLAYER_ONE;
-        }
+/**
+ * @brief Checks whether a game has started, without waiting. The first player to press
+ *        the button is player 1 and tells the other board, which becomes player 2 and
+ *        answers with START_ACK.
+ * 
+ * @param message The message just received, or MESSAGE_NONE.
+ * @return uint8_t PLAYER_ONE or PLAYER_TWO once a game has started, otherwise 0.
+ */
+uint8_t game_start_poll (Message_t message)
+{
+    button_update ();
+    start_contested = false;
+    if (message == MESSAGE_START) {
+        transmit_start_ack();
+        return PLAYER_TWO;
     }
+    if (button_push_event_p(0)) {
+        start_send();
+        start_contested = true;
+        return PLAYER_ONE;
+    }
+    return 0;
+}
+
+/**
+ * @brief Decides the player number when a START is received during a game. If this
+ *        board is player 1 and has not heard from player 2, both players pressed the
+ *        button at about the same time: the board with the higher nonce stays player 1,
+ *        and on equal nonces both boards send START again with new ones. Otherwise the
+ *        other board missed the end of this game and has started the next.
+ * 
+ * @return uint8_t PLAYER_TWO to start again as player 2, or 0 to carry on.
+ */
+uint8_t game_start_received (void)
+{
+    uint8_t nonce = transmission_start_nonce();
+
+    if (!start_contested || nonce > start_nonce) {
+        start_contested = false;
+        transmit_start_ack();
+        return PLAYER_TWO;
+    }
+    if (nonce == start_nonce) {
+        start_send();
+    }
+    return 0;
+}
+
+/**
+ * @brief Sends START again with a new nonce if player 2 has not answered in time.
+ *        This covers a lost START or START_ACK, and two STARTs with equal nonces
+ *        that each board discarded as the echo of its own.
+ * 
+ */
+void game_start_update (void)
+{
+    if (start_contested && (timer_tick_t)(timer_get() - start_sent) >= START_RESEND_TICKS) {
+        start_send();
+    }
+}
+
+/**
+ * @brief Ends the START handshake once player 1 has received START_ACK
+ *        or an arrow, as the other board must then be player 2.
+ * 
+ */
+void game_start_settled (void)
+{
+    start_contested = false;
 }
@@ -10,12 +10,52 @@
 #ifndef GAME_SETUP_H
 #define GAME_SETUP_H
 
+#include "transmission.h"
 #include <stdint.h>
 
+#define PLAYER_ONE 1
+#define PLAYER_TWO 2
+
+/**
+ * @brief Initialises the button and IR link used to start a game.
+ * 
+ */
+void game_init (void);
+
+/**
+ * @brief Checks whether a game has started, without waiting. The first player to press
+ *        the button is player 1 and tells the other board, which becomes player 2 and
+ *        answers with START_ACK.
+ * 
+ * @param message The message just received, or MESSAGE_NONE.
+ * @return uint8_t PLAYER_ONE or PLAYER_TWO once a game has started, otherwise 0.
+ */
+uint8_t game_start_poll (Message_t message);
+
+/**
+ * @brief Decides the player number when a START is received during a game. If this
+ *        board is player 1 and has not heard from player 2, both players pressed the
+ *        button at about the same time: the board with the higher nonce stays player 1,
+ *        and on equal nonces both boards send START again with new ones. Otherwise the
+ *        other board missed the end of this game and has started the next.
+ * 
+ * @return uint8_t PLAYER_TWO to start again as player 2, or 0 to carry on.
+ */
+uint8_t game_start_received (void);
+
+/**
+ * @brief Sends START again with a new nonce if player 2 has not answered in time.
+ *        This covers a lost START or START_ACK, and two STARTs with equal nonces
+ *        that each board discarded as the echo of its own.
+ * 
+ */
+void game_start_update (void);
+
 /**
- * @brief Initialises the game. First player to press the button is player 1.
+ * @brief Ends the START handshake once player 1 has received START_ACK
+ *        or an arrow, as the other board must then be player 2.
  * 
  */
-uint8_t game_init (void);
+void game_start_settled (void);
 
 #endif
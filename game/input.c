@@ -23,6 +23,21 @@ void input_init(void)
     navswitch_init();
 }
 
+/**
+ * @brief Polls the navswitch and throws away its events, so presses made
+ *        between games do not carry over into the next one.
+ * 
+ */
+void input_flush(void)
+{
+    navswitch_event_t event;
+
+    navswitch_update();
+    while (navswitch_event_get(&event)) {
+        continue;
+    }
+}
+
 /**
  * @brief for the player's input and changes arrows accordingly.
  *        Returns true if navswitch is pushed in.
@@ -32,23 +47,44 @@ void input_init(void)
  */
 bool player_input(Player_t* player)
 {
+    navswitch_event_t event;
+    bool pushed = false;
+
     navswitch_update();
-    
-    if (navswitch_push_event_p (NAVSWITCH_NORTH))
-        rotate_anticlockwise(&(player->player_arrow));
 
-    if (navswitch_push_event_p (NAVSWITCH_SOUTH))
-        rotate_clockwise(&(player->player_arrow));
+    // Take every press since the last call, in the order they happened.
+    while (navswitch_event_get(&event)) {
+        if (!event.pushed) {
+            continue;
+        }
+
+        switch (event.navswitch) {
+        case NAVSWITCH_NORTH:
+            rotate_anticlockwise(&(player->player_arrow));
+            break;
+
+        case NAVSWITCH_SOUTH:
+            rotate_clockwise(&(player->player_arrow));
+            break;
+
+        case NAVSWITCH_EAST:
+            move_arrow_left(&(player->player_arrow));
+            break;
 
-    if (navswitch_push_event_p (NAVSWITCH_EAST))
-        move_arrow_left(&(player->player_arrow));
+        case NAVSWITCH_WEST:
+            move_arrow_right(&(player->player_arrow));
+            break;
 
-    if (navswitch_push_event_p (NAVSWITCH_WEST))
-        move_arrow_right(&(player->player_arrow));
+        case NAVSWITCH_PUSH:
+            if (!pushed && player->is_sender && player->moves > 0) {
+                dec_moves(player);
+                pushed = true;
+            }
+            break;
 
-    if (navswitch_push_event_p (NAVSWITCH_PUSH) && player->is_sender && player->moves > 0){
-        dec_moves(player);
-        return true;
+        default:
+            break;
+        }
     }
-    return false;
+    return pushed;
 }
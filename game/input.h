@@ -19,6 +19,13 @@
  */
 void input_init(void);
 
+/**
+ * @brief Polls the navswitch and throws away its events, so presses made
+ *        between games do not carry over into the next one.
+ * 
+ */
+void input_flush(void);
+
 /**
  * @brief Checks for the player's input and changes arrows accordingly.
  *        Returns true if navswitch is pushed in.
@@ -0,0 +1,177 @@
+/**
+ * @file lanes.c
+ * @author Bede Nathan | nrb55
+ * @author Jaymee Chen | jch423
+ * @brief Arrows on the screen held as a bitboard for each lane and rotation.
+ * @date 2022-10-14
+ *
+ */
+
+#include "system.h"
+#include "arrow.h"
+#include "lanes.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define LANES_ROWS 16
+
+/**
+ * @brief Removes every arrow.
+ *
+ * @param lanes The lanes to be cleared.
+ */
+void lanes_clear(ArrowLanes_t* lanes)
+{
+    uint8_t x;
+    uint8_t rotation;
+
+    for (x = 0; x < LANES_NUM; x++) {
+        for (rotation = 0; rotation < LANES_ROTATIONS; rotation++) {
+            lanes->rows[x][rotation] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Returns the rows that have an arrow in any lane.
+ *
+ * @param lanes The lanes to be tested.
+ * @return LaneRows_t Bitmask of occupied rows.
+ */
+LaneRows_t lanes_occupied(ArrowLanes_t* lanes)
+{
+    LaneRows_t occupied = 0;
+    uint8_t x;
+    uint8_t rotation;
+
+    for (x = 0; x < LANES_NUM; x++) {
+        for (rotation = 0; rotation < LANES_ROTATIONS; rotation++) {
+            occupied |= lanes->rows[x][rotation];
+        }
+    }
+    return occupied;
+}
+
+/**
+ * @brief Returns true if there are no arrows.
+ *
+ * @param lanes The lanes to be tested.
+ * @return true There are no arrows.
+ * @return false There is at least one arrow.
+ */
+bool lanes_is_empty(ArrowLanes_t* lanes)
+{
+    return lanes_occupied(lanes) == 0;
+}
+
+/**
+ * @brief Adds an arrow, if no other arrow is within ARROW_DISTANCE rows of it.
+ *
+ * @param lanes The lanes to be added to.
+ * @param arrow Arrow to be added.
+ * @return true The arrow was added.
+ * @return false The arrow is too close to another, or off the board, and was not added.
+ */
+bool lanes_add(ArrowLanes_t* lanes, Arrow_t* arrow)
+{
+    LaneRows_t near;
+
+    if (arrow->x < 1 || arrow->x > LANES_NUM || arrow->y >= LANES_ROWS) {
+        return false;
+    }
+
+    // Rows y - ARROW_DISTANCE to y + ARROW_DISTANCE.
+    near = (((uint32_t)BIT(2 * ARROW_DISTANCE + 1) - 1) << arrow->y) >> ARROW_DISTANCE;
+    if (lanes_occupied(lanes) & near) {
+        return false;
+    }
+
+    lanes->rows[arrow->x - 1][arrow->rotation] |= BIT(arrow->y);
+    return true;
+}
+
+/**
+ * @brief Removes an arrow if there is one with the same position and rotation.
+ *
+ * @param lanes The lanes to be searched.
+ * @param arrow Arrow to be removed.
+ * @return true The arrow was found and removed.
+ * @return false There is no such arrow.
+ */
+bool lanes_remove(ArrowLanes_t* lanes, Arrow_t* arrow)
+{
+    LaneRows_t* rows;
+
+    if (arrow->x < 1 || arrow->x > LANES_NUM || arrow->y >= LANES_ROWS) {
+        return false;
+    }
+
+    rows = &lanes->rows[arrow->x - 1][arrow->rotation];
+    if (!(*rows & BIT(arrow->y))) {
+        return false;
+    }
+    *rows &= ~BIT(arrow->y);
+    return true;
+}
+
+/**
+ * @brief Removes every arrow on a set of rows, appending a copy of each to a queue.
+ *
+ * @param lanes The lanes to be searched.
+ * @param rows Bitmask of rows to be emptied.
+ * @param queue Queue to append the removed arrows to, or NULL. Arrows that do not fit are left in the lanes.
+ * @return uint8_t Number of arrows removed.
+ */
+uint8_t lanes_remove_rows(ArrowLanes_t* lanes, LaneRows_t rows, ArrowQueue_t* queue)
+{
+    uint8_t count = 0;
+    uint8_t x;
+    uint8_t rotation;
+
+    for (x = 0; x < LANES_NUM; x++) {
+        for (rotation = 0; rotation < LANES_ROTATIONS; rotation++) {
+            LaneRows_t found = lanes->rows[x][rotation] & rows;
+            Arrow_t arrow = {.x = x + 1, .y = 0, .rotation = rotation};
+
+            if (!found) {
+                continue;
+            }
+
+            // Arrows are spaced apart, so there are rarely more than one.
+            for (; found; found >>= 1, arrow.y++) {
+                if ((found & 1) && (queue == NULL || queue_append(queue, &arrow))) {
+                    lanes->rows[x][rotation] &= ~(1u << arrow.y);
+                    count++;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Moves every arrow by one row at once. Arrows moving towards the player
+ *        stop at row 0 until they are removed.
+ *
+ * @param lanes The lanes to be moved.
+ * @param direction Direction_t enum value for the direction of movement.
+ */
+void lanes_advance(ArrowLanes_t* lanes, Direction_t direction)
+{
+    uint8_t x;
+    uint8_t rotation;
+
+    for (x = 0; x < LANES_NUM; x++) {
+        for (rotation = 0; rotation < LANES_ROTATIONS; rotation++) {
+            LaneRows_t rows = lanes->rows[x][rotation];
+
+            if (direction == AWAY) {
+                rows <<= 1;
+            } else {
+                rows = (rows >> 1) | (rows & 1);
+            }
+            lanes->rows[x][rotation] = rows;
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/**
+ * @file lanes.h
+ * @author Bede Nathan | nrb55
+ * @author Jaymee Chen | jch423
+ * @brief Arrows on the screen held as a bitboard for each lane and rotation.
+ * @date 2022-10-14
+ *
+ * Rather than a list of arrows, the screen is a small bitmask for each
+ * pair of lane (x position) and rotation, with bit y set for an arrow
+ * centred on row y. Moving every arrow is a shift of each mask, and
+ * finding the arrows on a row, such as the one the player matches on,
+ * is an AND. The cost is the same however many arrows there are.
+ *
+ * Arrows only enter when no other arrow is within ARROW_DISTANCE rows,
+ * and they all move together, so they stay spaced apart and two arrows
+ * never share a bit.
+ */
+
+#ifndef LANES_H
+#define LANES_H
+
+#include "arrow.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Number of lanes; arrows have x from 1 to LANES_NUM.
+ */
+#define LANES_NUM 3
+
+/**
+ * @brief Number of rotations, one mask for each in every lane.
+ */
+#define LANES_ROTATIONS 4
+
+/**
+ * @brief Row just above the screen, where arrows leave the sender and enter the receiver.
+ */
+#define LANES_TOP_ROW 9
+
+/**
+ * @brief Bitmask of rows, bit 0 being the bottom row.
+ */
+typedef uint16_t LaneRows_t;
+
+/**
+ * @brief The arrows on the screen.
+ */
+typedef struct {
+    LaneRows_t rows[LANES_NUM][LANES_ROTATIONS];
+} ArrowLanes_t;
+
+/**
+ * @brief Removes every arrow.
+ *
+ * @param lanes The lanes to be cleared.
+ */
+void lanes_clear(ArrowLanes_t* lanes);
+
+/**
+ * @brief Returns the rows that have an arrow in any lane.
+ *
+ * @param lanes The lanes to be tested.
+ * @return LaneRows_t Bitmask of occupied rows.
+ */
+LaneRows_t lanes_occupied(ArrowLanes_t* lanes);
+
+/**
+ * @brief Returns true if there are no arrows.
+ *
+ * @param lanes The lanes to be tested.
+ * @return true There are no arrows.
+ * @return false There is at least one arrow.
+ */
+bool lanes_is_empty(ArrowLanes_t* lanes);
+
+/**
+ * @brief Adds an arrow, if no other arrow is within ARROW_DISTANCE rows of it.
+ *
+ * @param lanes The lanes to be added to.
+ * @param arrow Arrow to be added.
+ * @return true The arrow was added.
+ * @return false The arrow is too close to another, or off the board, and was not added.
+ */
+bool lanes_add(ArrowLanes_t* lanes, Arrow_t* arrow);
+
+/**
+ * @brief Removes an arrow if there is one with the same position and rotation.
+ *
+ * @param lanes The lanes to be searched.
+ * @param arrow Arrow to be removed.
+ * @return true The arrow was found and removed.
+ * @return false There is no such arrow.
+ */
+bool lanes_remove(ArrowLanes_t* lanes, Arrow_t* arrow);
+
+/**
+ * @brief Removes every arrow on a set of rows, appending a copy of each to a queue.
+ *
+ * @param lanes The lanes to be searched.
+ * @param rows Bitmask of rows to be emptied.
+ * @param queue Queue to append the removed arrows to, or NULL. Arrows that do not fit are left in the lanes.
+ * @return uint8_t Number of arrows removed.
+ */
+uint8_t lanes_remove_rows(ArrowLanes_t* lanes, LaneRows_t rows, ArrowQueue_t* queue);
+
+/**
+ * @brief Moves every arrow by one row at once. Arrows moving towards the player
+ *        stop at row 0 until they are removed.
+ *
+ * @param lanes The lanes to be moved.
+ * @param direction Direction_t enum value for the direction of movement.
+ */
+void lanes_advance(ArrowLanes_t* lanes, Direction_t direction);
+
+#endif
@@ -23,6 +23,7 @@
 Level_t level_init(void)
 {
     Level_t new_level;
+    new_level.level = 1;
     new_level.lives = START_LIVES;
     new_level.arrow_speed = START_SPEED;
     new_level.num_moves = START_MOVES;
@@ -30,12 +31,13 @@ Level_t level_init(void)
 }
 
 /**
- * @brief Updates the arrow speed and number of moves when the round is over.
+ * @brief Updates the level number, arrow speed and number of moves when the round is over.
  * 
  * @param game_level the current level object of the game.
  */
 void level_update(Level_t* game_level)
 {
+    game_level->level++;
     game_level->arrow_speed += ARROW_SPEED_INC;
     game_level->num_moves += MOVES_INC;
 }
\ No newline at end of file
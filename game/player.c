@@ -36,7 +36,9 @@ Player_t player_init(uint8_t num_players, Level_t* game_level)
         led_set(LED1, true);
     }
 
-    newPlayer.player_arrow = *new_arrow(DEFAULT_X, DEFAULT_Y, UP);
+    newPlayer.player_arrow.x = DEFAULT_X;
+    newPlayer.player_arrow.y = DEFAULT_Y;
+    newPlayer.player_arrow.rotation = UP;
     return newPlayer;
 }
 
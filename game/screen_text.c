@@ -7,46 +7,67 @@
  * 
  */
 #include "screen_text.h"
-#include "screen_text.h"
-#include "pacer.h"
 #include "tinygl.h"
-#include "../fonts/font3x5_1.h"
+#include "font3x5_game.h"
 #include <stdbool.h>
 #include <stdint.h>
 
 #define MESSAGE_RATE 40
 #define RESET_TIMER 15000
 
-char win_message[] = " =DYOU WIN  ";
-char lose_message[] = " =(YOU LOSE  ";
+// Only these characters are in font3x5_game; see SCREEN_TEXT_CHARS in the Makefile.
+// The messages stay in flash and are read as they scroll.
+static const char win_message[] PROGMEM = " =DYOU WIN  ";
+static const char lose_message[] PROGMEM = " =(YOU LOSE  ";
+
+// Ticks left before the end screen text is cleared.
+static uint16_t text_ticks = 0;
 
 /**
- * @brief Displays text on the screen when the game is over.
+ * @brief Starts showing text on the screen when the game is over. The text
+ *        is scrolled by display_win_update, so this returns at once.
  * 
  * @param is_win bool value for if the player is the winner or loser.
  */
 void display_win(bool is_win)
 {
     tinygl_text_mode_set (TINYGL_TEXT_MODE_SCROLL);
-    tinygl_font_set (&font3x5_1);
+    tinygl_font_set (&font3x5_game);
     tinygl_text_speed_set (MESSAGE_RATE);
     tinygl_text_dir_set(TINYGL_TEXT_DIR_ROTATE);
-    
+    tinygl_clear();
+
     if (is_win) {
-        tinygl_text(win_message);
+        tinygl_text_P(win_message);
     } else {
-        tinygl_text(lose_message);
+        tinygl_text_P(lose_message);
     }
+    text_ticks = RESET_TIMER;
+}
 
-    uint64_t tick = 0;
-    while(tick < RESET_TIMER)
-    {
-        pacer_wait();
-        
-        tinygl_update();
-        tick++;
+/**
+ * @brief Scrolls the end screen text. Call at TEXT_UPDATE_RATE while it is shown;
+ *        the screen is cleared after RESET_TIMER calls.
+ * 
+ */
+void display_win_update(void)
+{
+    if (!text_ticks) {
+        return;
+    }
+    text_ticks--;
+    if (!text_ticks) {
+        tinygl_clear();
     }
-    
-    tinygl_clear();
     tinygl_update();
 }
+
+/**
+ * @brief Stops the end screen text and clears the screen.
+ * 
+ */
+void display_win_stop(void)
+{
+    text_ticks = 0;
+    tinygl_clear();
+}
@@ -13,10 +13,29 @@
 #include <stdbool.h>
 
 /**
- * @brief Displays text on the screen when the game is over.
+ * @brief Rate in Hz that tinygl is updated while the end screen text is shown.
+ */
+#define TEXT_UPDATE_RATE 1000
+
+/**
+ * @brief Starts showing text on the screen when the game is over. The text
+ *        is scrolled by display_win_update, so this returns at once.
  * 
  * @param is_win bool value for if the player is the winner or loser.
  */
 void display_win(bool is_win);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Scrolls the end screen text. Call at TEXT_UPDATE_RATE while it is shown;
+ *        the screen is cleared after RESET_TIMER calls.
+ * 
+ */
+void display_win_update(void);
+
+/**
+ * @brief Stops the end screen text and clears the screen.
+ * 
+ */
+void display_win_stop(void);
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file sprite.c
+ * @author Bede Nathan | nrb55
+ * @author Jaymee Chen | jch423
+ * @brief Sprite layer that composites the arrows into the display once per frame.
+ * @date 2022-10-14
+ * 
+ */
+
+#include "system.h"
+#include "display.h"
+#include "arrow.h"
+#include "lanes.h"
+#include "sprite.h"
+#include <stdint.h>
+
+// Number of display columns an arrow covers, centred on its x position.
+#define SPRITE_WIDTH 3
+
+// Row of the player's arrow, where arrows are brightest.
+#define SPRITE_NEAR_ROW 1
+
+/**
+ * @brief Column masks for each rotation, for columns x - 1, x and x + 1.
+ *        Bit 0 is row y - 1, bit 1 is row y and bit 2 is row y + 1.
+ */
+static const uint8_t sprite_masks[][SPRITE_WIDTH] =
+{
+    [DOWN] = {0x2, 0x1, 0x2},
+    [LEFT] = {0x0, 0x5, 0x2},
+    [UP] = {0x2, 0x4, 0x2},
+    [RIGHT] = {0x2, 0x5, 0x0},
+};
+
+// The frame being built, a bitmap for each bit of the pixel levels.
+static uint8_t frame[DISPLAY_PLANES][DISPLAY_WIDTH];
+
+/**
+ * @brief Starts a new frame with every pixel off.
+ * 
+ */
+void sprite_frame_clear(void)
+{
+    uint8_t plane;
+    uint8_t col;
+
+    for (plane = 0; plane < DISPLAY_PLANES; plane++) {
+        for (col = 0; col < DISPLAY_WIDTH; col++) {
+            frame[plane][col] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Returns the brightness of an arrow, which fades with its distance from the
+ *        player's row at the top of the display. Every arrow on the display is lit.
+ * 
+ * @param y Row of the arrow's centre.
+ * @return uint8_t Brightness from 1 to DISPLAY_LEVEL_MAX.
+ */
+static uint8_t sprite_level(uint8_t y)
+{
+    uint8_t distance = y > SPRITE_NEAR_ROW ? y - SPRITE_NEAR_ROW : 0;
+    uint8_t fade = distance * DISPLAY_LEVEL_MAX / DISPLAY_HEIGHT;
+
+    return fade < DISPLAY_LEVEL_MAX ? DISPLAY_LEVEL_MAX - fade : 1;
+}
+
+/**
+ * @brief Adds an arrow to the frame being built.
+ * 
+ * @param arrow Arrow to be drawn.
+ */
+void sprite_add(Arrow_t* arrow)
+{
+    const uint8_t* masks = sprite_masks[arrow->rotation];
+    uint8_t col = arrow->x - 1;
+    uint8_t level;
+    uint8_t plane;
+    uint8_t i;
+
+    // Arrows wholly above or below the display have nothing to draw.
+    if (arrow->y > DISPLAY_HEIGHT) {
+        return;
+    }
+
+    level = sprite_level(arrow->y);
+    for (i = 0; i < SPRITE_WIDTH; i++, col++) {
+        if (col < DISPLAY_WIDTH) {
+            // Shift the mask so bit 0 lands on row y - 1; row -1 falls off the bottom.
+            uint8_t pattern = ((uint16_t)masks[i] << arrow->y) >> 1;
+            uint8_t bits;
+
+            // Only the planes whose bit is set in the level.
+            for (plane = 0, bits = level; bits; plane++, bits >>= 1) {
+                if (bits & 1) {
+                    frame[plane][col] |= pattern;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Adds every arrow on the screen to the frame being built.
+ * 
+ * @param lanes Arrows to be drawn.
+ */
+void sprite_add_lanes(ArrowLanes_t* lanes)
+{
+    Arrow_t arrow;
+    uint8_t x;
+    uint8_t rotation;
+
+    for (x = 0; x < LANES_NUM; x++) {
+        for (rotation = 0; rotation < LANES_ROTATIONS; rotation++) {
+            // Only the rows sprite_add can draw.
+            LaneRows_t rows = lanes->rows[x][rotation] & (BIT(DISPLAY_HEIGHT + 1) - 1);
+
+            arrow.x = x + 1;
+            arrow.rotation = rotation;
+            for (arrow.y = 0; rows; rows >>= 1, arrow.y++) {
+                if (rows & 1) {
+                    sprite_add(&arrow);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copies the finished frame to the display.
+ * 
+ */
+void sprite_frame_show(void)
+{
+    display_frame_set((const uint8_t (*)[DISPLAY_WIDTH])frame);
+}
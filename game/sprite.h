@@ -0,0 +1,51 @@
+/**
+ * @file sprite.h
+ * @author Bede Nathan | nrb55
+ * @author Jaymee Chen | jch423
+ * @brief Sprite layer that composites the arrows into the display once per frame.
+ * @date 2022-10-14
+ * 
+ * Arrows are drawn from precomputed column bitmasks, one set per
+ * Rotation_t. A frame is built by clearing it, adding every live
+ * arrow, then showing it, which writes each display column once.
+ * Overlapping arrows are OR'd together so moving one arrow never
+ * erases part of another.
+ *
+ * When the display has several bit planes, arrows fade with their
+ * distance from the player's row, and the frame holds a bitmap for
+ * each plane.
+ */
+
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include "arrow.h"
+#include "lanes.h"
+
+/**
+ * @brief Starts a new frame with every pixel off.
+ * 
+ */
+void sprite_frame_clear(void);
+
+/**
+ * @brief Adds an arrow to the frame being built.
+ * 
+ * @param arrow Arrow to be drawn.
+ */
+void sprite_add(Arrow_t* arrow);
+
+/**
+ * @brief Adds every arrow on the screen to the frame being built.
+ * 
+ * @param lanes Arrows to be drawn.
+ */
+void sprite_add_lanes(ArrowLanes_t* lanes);
+
+/**
+ * @brief Copies the finished frame to the display.
+ * 
+ */
+void sprite_frame_show(void);
+
+#endif
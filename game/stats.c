@@ -0,0 +1,61 @@
+/**
+ * @file stats.c
+ * @author Bede Nathan | nrb55
+ * @author Jaymee Chen | jch423
+ * @brief Stats module that keeps the high score and lifetime results in EEPROM.
+ * @date 2022-10-14
+ * 
+ */
+
+#include "stats.h"
+#include "kvstore.h"
+#include "transmission.h"
+
+// Link errors stored before this power up, as the receiver's count starts at zero.
+static uint32_t link_errors_base = 0;
+
+/**
+ * @brief Loads the statistics from EEPROM. Must be called before the other functions.
+ * 
+ */
+void stats_init(void)
+{
+    kvstore_init();
+    link_errors_base = stats_get(STATS_LINK_ERRORS);
+}
+
+/**
+ * @brief Returns a statistic.
+ * 
+ * @param stat the statistic to get.
+ * @return uint32_t its value, zero if it has never been set.
+ */
+uint32_t stats_get(Stat_t stat)
+{
+    uint32_t value = 0;
+
+    kvstore_get(stat, &value);
+    return value;
+}
+
+/**
+ * @brief Records the result of a game, only writing the statistics that change.
+ * 
+ * @param won true if the player won.
+ * @param level the level the game reached.
+ */
+void stats_game_over(bool won, uint8_t level)
+{
+    if (won) {
+        kvstore_set(STATS_WINS, stats_get(STATS_WINS) + 1);
+    } else {
+        kvstore_set(STATS_LOSSES, stats_get(STATS_LOSSES) + 1);
+    }
+
+    if (level > stats_get(STATS_HIGH_SCORE)) {
+        kvstore_set(STATS_HIGH_SCORE, level);
+    }
+
+    // kvstore_set does not write a value that has not changed.
+    kvstore_set(STATS_LINK_ERRORS, link_errors_base + transmission_error_count());
+}
@@ -0,0 +1,49 @@
+/**
+ * @file stats.h
+ * @author Bede Nathan | nrb55
+ * @author Jaymee Chen | jch423
+ * @brief Stats module that keeps the high score and lifetime results in EEPROM.
+ * @date 2022-10-14
+ * 
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief The statistics that are kept. Each is a key in the EEPROM store.
+ */
+typedef enum {
+    STATS_HIGH_SCORE,
+    STATS_WINS,
+    STATS_LOSSES,
+    STATS_LINK_ERRORS,
+    STATS_NUM
+} Stat_t;
+
+/**
+ * @brief Loads the statistics from EEPROM. Must be called before the other functions.
+ * 
+ */
+void stats_init(void);
+
+/**
+ * @brief Returns a statistic.
+ * 
+ * @param stat the statistic to get.
+ * @return uint32_t its value, zero if it has never been set.
+ */
+uint32_t stats_get(Stat_t stat);
+
+/**
+ * @brief Records the result of a game, only writing the statistics that change.
+ * 
+ * @param won true if the player won.
+ * @param level the level the game reached.
+ */
+void stats_game_over(bool won, uint8_t level);
+
+#endif
@@ -0,0 +1,539 @@
+/**
+ * @file blit_bench.c
+ * @author Bede Nathan | nrb55
+ * @author Jaymee Chen | jch423
+ * @brief Host benchmark of glyph and arrow drawing, per pixel versus per column.
+ * @date 2022-10-14
+ *
+ * The "pixel" rows reproduce the old drawing code, which set every
+ * pixel through tinygl_draw_point with its own bounds check. The
+ * "column" rows use tinygl_draw_char and the sprite layer, which
+ * write whole display columns with display_blit. Both paths are
+ * checked to leave the same frame buffer.
+ *
+ * The glyph rows time drawing the end of game messages as they
+ * scroll, in both text directions: each scroll step draws the two
+ * characters on the display. Every character is either rasterised,
+ * as tinygl_draw_char did before its glyph cache, or taken from the
+ * cache.
+ *
+ * The scroll rows time advancing scrolling text, redrawing every
+ * character on the display each step as tinygl used to, or shifting
+ * the display and drawing the new column. The shifted frames are
+ * first checked against the redrawn ones, for a message longer than
+ * TINYGL_MESSAGE_SIZE given to tinygl_draw_message_P.
+ *
+ * The column-major fonts and the end screen subset are first checked
+ * against the row-major fonts they were generated from, and scrolled
+ * too.
+ *
+ * Build with "make -f Makefile.test blit_bench" and run as
+ * "./blit_bench [iterations]".
+ */
+
+#include "arrow.h"
+#include "sprite.h"
+#include "display.h"
+#include "font.h"
+#include "tinygl.h"
+#include "../fonts/font3x5_1.h"
+#include "../fonts/font3x5_1_c.h"
+#include "../fonts/font5x7_1.h"
+#include "../fonts/font5x7_1_c.h"
+#include "font3x5_game.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS 1000000L
+#define NUM_ARROWS 4
+
+static const char bench_message[] = " =DYOU WIN   =(YOU LOSE  ";
+static const char scroll_message[] PROGMEM = "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 0123456789";
+
+static font_t* bench_font;
+
+/**
+ * @brief Returns the seconds elapsed between two timestamps.
+ *
+ * @param start Start time.
+ * @param end End time.
+ * @return double elapsed seconds.
+ */
+static double elapsed_seconds(struct timespec* start, struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/**
+ * @brief Prints the throughput of one benchmark.
+ *
+ * @param name Name of the benchmark.
+ * @param pixels Number of pixels drawn.
+ * @param seconds Time taken.
+ */
+static void report(const char* name, long pixels, double seconds)
+{
+    printf("%-16s %11ld pixels %8.3f s %8.2f Mpixels/s\n",
+           name, pixels, seconds, pixels / seconds * 1e-6);
+}
+
+/**
+ * @brief Returns a checksum of the display frame buffer.
+ *
+ * @return unsigned long checksum.
+ */
+static unsigned long frame_checksum(void)
+{
+    unsigned long sum = 0;
+    uint8_t col;
+
+    for (col = 0; col < DISPLAY_WIDTH; col++) {
+        sum = sum * 131 + display_column_get(col);
+    }
+    return sum;
+}
+
+/**
+ * @brief Draws a character a pixel at a time, as tinygl_draw_char used to.
+ *
+ * @param ch Character to draw.
+ * @param pos Coordinates of top left position.
+ */
+static void pixel_draw_char(char ch, tinygl_point_t pos)
+{
+    uint8_t x;
+    uint8_t y;
+
+    for (x = 0; x < bench_font->width; x++) {
+        for (y = 0; y < bench_font->height; y++) {
+            tinygl_draw_point(tinygl_point(pos.x, y + pos.y),
+                              font_pixel_get(bench_font, ch, x, y));
+        }
+        pos.x++;
+    }
+    for (y = 0; y < bench_font->height; y++) {
+        tinygl_draw_point(tinygl_point(pos.x, y + pos.y), 0);
+    }
+}
+
+/**
+ * @brief Draws an arrow a pixel at a time, as update_arrow used to.
+ *
+ * @param arrow Arrow to draw.
+ */
+static void pixel_draw_arrow(Arrow_t* arrow)
+{
+    switch (arrow->rotation) {
+    case DOWN:
+        tinygl_draw_point(tinygl_point(arrow->x, arrow->y - 1), 1);
+        tinygl_draw_point(tinygl_point(arrow->x - 1, arrow->y), 1);
+        tinygl_draw_point(tinygl_point(arrow->x + 1, arrow->y), 1);
+        break;
+
+    case UP:
+        tinygl_draw_point(tinygl_point(arrow->x, arrow->y + 1), 1);
+        tinygl_draw_point(tinygl_point(arrow->x - 1, arrow->y), 1);
+        tinygl_draw_point(tinygl_point(arrow->x + 1, arrow->y), 1);
+        break;
+
+    case LEFT:
+        tinygl_draw_point(tinygl_point(arrow->x + 1, arrow->y), 1);
+        tinygl_draw_point(tinygl_point(arrow->x, arrow->y + 1), 1);
+        tinygl_draw_point(tinygl_point(arrow->x, arrow->y - 1), 1);
+        break;
+
+    case RIGHT:
+        tinygl_draw_point(tinygl_point(arrow->x - 1, arrow->y), 1);
+        tinygl_draw_point(tinygl_point(arrow->x, arrow->y + 1), 1);
+        tinygl_draw_point(tinygl_point(arrow->x, arrow->y - 1), 1);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Times drawing glyphs both ways with one font.
+ *
+ * @param name Name of the font.
+ * @param font Font to draw with.
+ * @param iterations Number of glyphs to draw.
+ * @return int 0 if both paths drew the same pixels.
+ */
+static int bench_glyphs(const char* name, font_t* font, long iterations)
+{
+    struct timespec start;
+    struct timespec end;
+    long pixels = iterations * (font->width + 1) * font->height;
+    unsigned long pixel_sum = 0;
+    unsigned long column_sum = 0;
+    char label[32];
+    long i;
+
+    bench_font = font;
+    tinygl_font_set(font);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++) {
+        pixel_draw_char(' ' + i % font->size, tinygl_point(0, 0));
+        pixel_sum += display_column_get(i % DISPLAY_WIDTH);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    snprintf(label, sizeof(label), "%s pixel", name);
+    report(label, pixels, elapsed_seconds(&start, &end));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++) {
+        tinygl_draw_char(' ' + i % font->size, tinygl_point(0, 0));
+        column_sum += display_column_get(i % DISPLAY_WIDTH);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    snprintf(label, sizeof(label), "%s column", name);
+    report(label, pixels, elapsed_seconds(&start, &end));
+
+    if (pixel_sum != column_sum) {
+        fprintf(stderr, "%s: glyph drawing differs (%lu != %lu)\n", name, pixel_sum, column_sum);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Draws a character by rasterising it from the font, as tinygl_draw_char
+ *        did before it cached glyphs.
+ *
+ * @param ch Character to draw.
+ * @param pos Coordinates of top left position.
+ * @param dir Text direction.
+ */
+static void uncached_draw_char(char ch, tinygl_point_t pos, tinygl_text_dir_t dir)
+{
+    uint8_t columns[8];
+    uint8_t width = bench_font->width;
+    uint8_t height = bench_font->height;
+
+    font_columns_get(bench_font, ch, columns);
+
+    if (dir == TINYGL_TEXT_DIR_ROTATE) {
+        uint8_t rows[8];
+        uint8_t x;
+        uint8_t y;
+
+        for (x = 0; x < height; x++) {
+            rows[x] = 0;
+            for (y = 0; y < width; y++) {
+                if (columns[y] & BIT(x)) {
+                    rows[x] |= BIT(width - y);
+                }
+            }
+        }
+        display_blit(pos.x, pos.y - width, rows, height, width + 1);
+    } else {
+        columns[width] = 0;
+        display_blit(pos.x, pos.y, columns, width + 1, height);
+    }
+}
+
+/**
+ * @brief Returns the i-th character drawn while scrolling the message.
+ *
+ * @param i Glyph number.
+ * @return char Character.
+ */
+static char scroll_char(long i)
+{
+    long step = i / 2;
+
+    return bench_message[(step / (bench_font->width + 1) + i % 2) % (sizeof(bench_message) - 1)];
+}
+
+/**
+ * @brief Times scrolling the message, uncached and cached, in one direction.
+ *
+ * @param name Name of the font.
+ * @param font Font to draw with.
+ * @param dir Text direction.
+ * @param iterations Number of glyphs to draw.
+ * @return int Number of characters drawn differently.
+ */
+static int bench_glyph_cache(const char* name, font_t* font, tinygl_text_dir_t dir, long iterations)
+{
+    struct timespec start;
+    struct timespec end;
+    tinygl_point_t pos;
+    unsigned long uncached_sum;
+    double seconds;
+    const char* dir_name = dir == TINYGL_TEXT_DIR_ROTATE ? "rotate" : "normal";
+    int errors = 0;
+    long i;
+
+    bench_font = font;
+    tinygl_font_set(font);
+    tinygl_text_dir_set(dir);
+    pos = dir == TINYGL_TEXT_DIR_ROTATE ? tinygl_point(0, DISPLAY_HEIGHT - 1) : tinygl_point(0, 0);
+
+    // Check every character of the message first, so the cache is also checked when it is full.
+    for (i = 0; i < (long)sizeof(bench_message) - 1; i++) {
+        display_clear();
+        uncached_draw_char(bench_message[i], pos, dir);
+        uncached_sum = frame_checksum();
+        display_clear();
+        tinygl_draw_char(bench_message[i], pos);
+        if (frame_checksum() != uncached_sum) {
+            fprintf(stderr, "%s %s: cached glyph '%c' differs\n", name, dir_name, bench_message[i]);
+            errors++;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++) {
+        uncached_draw_char(scroll_char(i), pos, dir);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = elapsed_seconds(&start, &end);
+    printf("%-12s %s uncached %11ld glyphs %8.3f s %8.2f Mglyphs/s\n",
+           name, dir_name, iterations, seconds, iterations / seconds * 1e-6);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++) {
+        tinygl_draw_char(scroll_char(i), pos);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = elapsed_seconds(&start, &end);
+    printf("%-12s %s cached   %11ld glyphs %8.3f s %8.2f Mglyphs/s\n",
+           name, dir_name, iterations, seconds, iterations / seconds * 1e-6);
+
+    tinygl_text_dir_set(TINYGL_TEXT_DIR_NORMAL);
+    return errors;
+}
+
+/**
+ * @brief Draws a step of scrolling text by redrawing the characters on the display,
+ *        as tinygl did before it scrolled the display.
+ *
+ * @param message Message, which starts with two blank columns.
+ * @param step Scroll step.
+ * @param pos Position of the message.
+ * @param dir Text direction.
+ */
+static void redraw_scroll(const char* message, long step, tinygl_point_t pos, tinygl_text_dir_t dir)
+{
+    long cols = (long)strlen(message) * (bench_font->width + 1) + 2;
+    long col = step % cols - 2;
+    long index = col < 0 ? 0 : col / (bench_font->width + 1);
+    long scroll_pos = col < 0 ? col : col % (bench_font->width + 1);
+
+    if (dir == TINYGL_TEXT_DIR_ROTATE) {
+        pos.y += scroll_pos;
+    } else {
+        pos.x -= scroll_pos;
+    }
+    tinygl_draw_string(message + index, pos);
+}
+
+/**
+ * @brief Checks and times scrolling text in one direction.
+ *
+ * @param name Name of the font.
+ * @param font Font to draw with.
+ * @param dir Text direction.
+ * @param steps Number of scroll steps.
+ * @return int Number of frames that differ.
+ */
+static int bench_scroll(const char* name, font_t* font, tinygl_text_dir_t dir, long steps)
+{
+    static unsigned long sums[sizeof(scroll_message) * 8];
+    struct timespec start;
+    struct timespec end;
+    tinygl_point_t pos;
+    double seconds;
+    const char* dir_name = dir == TINYGL_TEXT_DIR_ROTATE ? "rotate" : "normal";
+    long frames;
+    int errors = 0;
+    long i;
+
+    // With an update rate of 1 Hz every update advances the message.
+    tinygl_init(1);
+    bench_font = font;
+    tinygl_font_set(font);
+    tinygl_text_mode_set(TINYGL_TEXT_MODE_SCROLL);
+    tinygl_text_dir_set(dir);
+    pos = dir == TINYGL_TEXT_DIR_ROTATE ? tinygl_point(0, DISPLAY_HEIGHT - 1) : tinygl_point(0, 0);
+
+    // Compare the frames until the end of the message reaches the edge of the display.
+    frames = (long)(sizeof(scroll_message) - 1) * (font->width + 1) + 2
+        - (dir == TINYGL_TEXT_DIR_ROTATE ? DISPLAY_HEIGHT : DISPLAY_WIDTH);
+    tinygl_draw_message_P(scroll_message, pos, 1);
+    for (i = 0; i < frames; i++) {
+        tinygl_update();
+        sums[i] = frame_checksum();
+    }
+    for (i = 0; i < frames; i++) {
+        display_clear();
+        redraw_scroll(scroll_message, i, pos, dir);
+        if (frame_checksum() != sums[i] && errors++ < 5) {
+            fprintf(stderr, "%s %s: scroll step %ld differs\n", name, dir_name, i);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < steps; i++) {
+        redraw_scroll(bench_message, i, pos, dir);
+        display_swap();
+        display_update();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = elapsed_seconds(&start, &end);
+    printf("%-12s %s redraw   %11ld steps  %8.3f s %8.2f Msteps/s\n",
+           name, dir_name, steps, seconds, steps / seconds * 1e-6);
+
+    // A repeated message stops after 255 times, so start it again well before then.
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < steps; i++) {
+        if (i % (100L * sizeof(bench_message) * (font->width + 1)) == 0) {
+            tinygl_text(bench_message);
+        }
+        tinygl_update();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = elapsed_seconds(&start, &end);
+    printf("%-12s %s shift    %11ld steps  %8.3f s %8.2f Msteps/s\n",
+           name, dir_name, steps, seconds, steps / seconds * 1e-6);
+
+    tinygl_clear();
+    tinygl_text_dir_set(TINYGL_TEXT_DIR_NORMAL);
+    return errors;
+}
+
+/**
+ * @brief Checks that a font generated in another format has the same pixels as the original.
+ *
+ * @param name Name of the generated font.
+ * @param font Original font.
+ * @param other Generated font.
+ * @return int Number of characters that differ.
+ */
+static int check_font(const char* name, font_t* font, font_t* other)
+{
+    uint8_t columns[8];
+    uint8_t other_columns[8];
+    int errors = 0;
+    int ch;
+    uint8_t x;
+    uint8_t y;
+
+    for (ch = 1; ch < 128; ch++) {
+        bool differ = false;
+
+        if (!font_contains_p(other, ch)) {
+            continue;
+        }
+        font_columns_get(font, ch, columns);
+        font_columns_get(other, ch, other_columns);
+        differ = memcmp(columns, other_columns, font->width) != 0;
+        for (x = 0; x < font->width; x++) {
+            for (y = 0; y < font->height; y++) {
+                differ |= font_pixel_get(font, ch, x, y) != font_pixel_get(other, ch, x, y);
+            }
+        }
+        if (other->flags & FONT_COLUMNS) {
+            differ |= memcmp(columns, font_columns(other, ch), font->width) != 0;
+        }
+        if (differ) {
+            fprintf(stderr, "%s: '%c' differs\n", name, ch);
+            errors++;
+        }
+    }
+    return errors;
+}
+
+/**
+ * @brief Times drawing a frame of arrows both ways.
+ *
+ * @param iterations Number of frames to draw.
+ * @return int 0 if both paths drew the same pixels.
+ */
+static int bench_sprites(long iterations)
+{
+    Arrow_t arrows[NUM_ARROWS];
+    struct timespec start;
+    struct timespec end;
+    long pixels = iterations * NUM_ARROWS * 3;
+    unsigned long pixel_sum = 0;
+    unsigned long column_sum = 0;
+    long i;
+    uint8_t j;
+
+    for (j = 0; j < NUM_ARROWS; j++) {
+        arrows[j].x = 1 + j % 3;
+        arrows[j].rotation = j % 4;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++) {
+        display_clear();
+        for (j = 0; j < NUM_ARROWS; j++) {
+            arrows[j].y = (i + j * 2) % (DISPLAY_HEIGHT + 1);
+            pixel_draw_arrow(&arrows[j]);
+        }
+        pixel_sum += frame_checksum();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    report("sprite pixel", pixels, elapsed_seconds(&start, &end));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++) {
+        sprite_frame_clear();
+        for (j = 0; j < NUM_ARROWS; j++) {
+            arrows[j].y = (i + j * 2) % (DISPLAY_HEIGHT + 1);
+            sprite_add(&arrows[j]);
+        }
+        sprite_frame_show();
+        column_sum += frame_checksum();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    report("sprite column", pixels, elapsed_seconds(&start, &end));
+
+    if (pixel_sum != column_sum) {
+        fprintf(stderr, "sprite drawing differs (%lu != %lu)\n", pixel_sum, column_sum);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    long iterations = argc > 1 ? atol(argv[1]) : DEFAULT_ITERATIONS;
+    int errors = 0;
+
+    display_init();
+
+    errors += bench_glyphs("font3x5_1", &font3x5_1, iterations);
+    errors += bench_glyphs("font5x7_1", &font5x7_1, iterations);
+    errors += check_font("font3x5_1_c", &font3x5_1, &font3x5_1_c);
+    errors += check_font("font5x7_1_c", &font5x7_1, &font5x7_1_c);
+    errors += check_font("font3x5_game", &font3x5_1, &font3x5_game);
+    printf("font3x5_1 %u bytes, font3x5_1_c %u bytes, font3x5_game %u bytes\n",
+           (unsigned)(sizeof(font3x5_1) + font3x5_1.size * font3x5_1.bytes),
+           (unsigned)(sizeof(font3x5_1_c) + font3x5_1_c.size * font3x5_1_c.bytes),
+           (unsigned)(sizeof(font3x5_game) + font3x5_game.size * (1 + font3x5_game.bytes)));
+
+    errors += bench_glyph_cache("font3x5_1", &font3x5_1, TINYGL_TEXT_DIR_NORMAL, iterations);
+    errors += bench_glyph_cache("font3x5_1", &font3x5_1, TINYGL_TEXT_DIR_ROTATE, iterations);
+    errors += bench_glyph_cache("font3x5_1_c", &font3x5_1_c, TINYGL_TEXT_DIR_NORMAL, iterations);
+    errors += bench_glyph_cache("font3x5_1_c", &font3x5_1_c, TINYGL_TEXT_DIR_ROTATE, iterations);
+    errors += bench_glyph_cache("font5x7_1", &font5x7_1, TINYGL_TEXT_DIR_NORMAL, iterations);
+    errors += bench_glyph_cache("font5x7_1", &font5x7_1, TINYGL_TEXT_DIR_ROTATE, iterations);
+    errors += bench_glyph_cache("font5x7_1_c", &font5x7_1_c, TINYGL_TEXT_DIR_NORMAL, iterations);
+    errors += bench_glyph_cache("font5x7_1_c", &font5x7_1_c, TINYGL_TEXT_DIR_ROTATE, iterations);
+    errors += bench_scroll("font3x5_1_c", &font3x5_1_c, TINYGL_TEXT_DIR_NORMAL, iterations);
+    errors += bench_scroll("font3x5_1_c", &font3x5_1_c, TINYGL_TEXT_DIR_ROTATE, iterations);
+    errors += bench_scroll("font5x7_1_c", &font5x7_1_c, TINYGL_TEXT_DIR_NORMAL, iterations);
+    errors += bench_scroll("font5x7_1_c", &font5x7_1_c, TINYGL_TEXT_DIR_ROTATE, iterations);
+    errors += bench_sprites(iterations);
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,332 @@
+/**
+ * @file kvstore_bench.c
+ * @author Bede Nathan | nrb55
+ * @author Jaymee Chen | jch423
+ * @brief Host benchmark of the EEPROM statistics store: boot scan cost, wear and power loss.
+ * @date 2022-10-14
+ *
+ * The store runs on an EEPROM in memory that counts the reads and the
+ * writes to each cell. Games are played through the stats module with
+ * a random result, level and number of link errors. The benchmark
+ * reports:
+ *
+ * - the time and EEPROM bytes read by kvstore_init for an erased
+ *   store, one just filled and one whose sequence numbers have wrapped;
+ * - the spread of writes over the cells after many games, against
+ *   keeping each statistic in a fixed record;
+ * - whether the statistics survive power being cut part way through
+ *   the writes of a game.
+ *
+ * Build with "make -f Makefile.test kvstore_bench" and run as
+ * "./kvstore_bench [games] [power_cuts]".
+ */
+
+#include "eeprom.h"
+#include "kvstore.h"
+#include "stats.h"
+#include "transmission.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define EEPROM_SIZE KVSTORE_SIZE
+#define EEPROM_ENDURANCE 100000
+#define DEFAULT_GAMES 100000L
+#define DEFAULT_POWER_CUTS 10000L
+#define SCAN_REPEATS 2000
+#define MAX_LEVEL 12
+
+static uint8_t eeprom[EEPROM_SIZE];
+static unsigned long eeprom_wear[EEPROM_SIZE];
+static unsigned long eeprom_reads;
+
+// Byte writes left before the power is cut, or -1 for none.
+static long power_left = -1;
+
+static uint16_t link_errors;
+static uint64_t rng = 1;
+
+eeprom_size_t eeprom_read(eeprom_addr_t addr, void* buffer, eeprom_size_t size)
+{
+    eeprom_size_t i;
+    uint8_t* data = buffer;
+
+    for (i = 0; i < size && addr < EEPROM_SIZE; i++) {
+        data[i] = eeprom[addr++];
+    }
+    eeprom_reads += i;
+    return i;
+}
+
+eeprom_size_t eeprom_write_async(eeprom_addr_t addr, const void* buffer, eeprom_size_t size)
+{
+    eeprom_size_t i;
+    const uint8_t* data = buffer;
+
+    // Like the driver, unchanged bytes are not written.
+    for (i = 0; i < size && addr < EEPROM_SIZE; i++, addr++) {
+        if (eeprom[addr] == data[i] || power_left == 0) {
+            continue;
+        }
+        if (power_left > 0) {
+            power_left--;
+        }
+        eeprom[addr] = data[i];
+        eeprom_wear[addr]++;
+    }
+    return i;
+}
+
+eeprom_size_t eeprom_write(eeprom_addr_t addr, const void* buffer, eeprom_size_t size)
+{
+    return eeprom_write_async(addr, buffer, size);
+}
+
+bool eeprom_write_done_p(void)
+{
+    return 1;
+}
+
+void eeprom_flush(void)
+{
+}
+
+/**
+ * @brief Stands in for the receiver's count of corrupt bytes, which starts at zero on power up.
+ *
+ * @return uint16_t Number of link errors since power up.
+ */
+uint16_t transmission_error_count(void)
+{
+    return link_errors;
+}
+
+/**
+ * @brief Returns the next pseudo-random number (xorshift64*).
+ *
+ * @return uint32_t Random number.
+ */
+static uint32_t random_next(void)
+{
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return (rng * 2685821657736338717ULL) >> 32;
+}
+
+/**
+ * @brief Returns the seconds elapsed between two timestamps.
+ *
+ * @param start Start time.
+ * @param end End time.
+ * @return double elapsed seconds.
+ */
+static double elapsed_seconds(struct timespec* start, struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/**
+ * @brief Erases the EEPROM and its counters, then powers up.
+ *
+ */
+static void eeprom_erase(void)
+{
+    memset(eeprom, 0xff, sizeof(eeprom));
+    memset(eeprom_wear, 0, sizeof(eeprom_wear));
+    link_errors = 0;
+    stats_init();
+}
+
+/**
+ * @brief Plays one game: a random result and level, and sometimes a few link errors.
+ *
+ */
+static void play_game(void)
+{
+    uint32_t r = random_next();
+
+    if ((r & 0xff) < 16) {
+        link_errors += 1 + (r >> 8) % 4;
+    }
+    stats_game_over((r >> 16) & 1, 1 + (r >> 17) % MAX_LEVEL);
+}
+
+/**
+ * @brief Times kvstore_init on the current EEPROM contents.
+ *
+ * @param name Description of the contents.
+ */
+static void scan_report(const char* name)
+{
+    struct timespec start;
+    struct timespec end;
+    unsigned long reads;
+    double seconds;
+    int i;
+
+    eeprom_reads = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < SCAN_REPEATS; i++) {
+        kvstore_init();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    reads = eeprom_reads / SCAN_REPEATS;
+    seconds = elapsed_seconds(&start, &end) / SCAN_REPEATS;
+
+    printf("scan %-8s %5lu bytes read %8.2f us, sequence %u\n",
+           name, reads, seconds * 1e6, kvstore_sequence_get());
+}
+
+/**
+ * @brief Counts the byte writes made by keeping each statistic in its own
+ *        fixed four-byte record, writing only the bytes that change.
+ *
+ * @param fixed Last value written for each statistic.
+ * @param wear Writes to each byte of the fixed records.
+ */
+static void fixed_update(uint32_t* fixed, unsigned long* wear)
+{
+    uint8_t stat;
+    uint8_t i;
+
+    for (stat = 0; stat < STATS_NUM; stat++) {
+        uint32_t value = stats_get(stat);
+
+        for (i = 0; i < 4; i++) {
+            if (((value ^ fixed[stat]) >> (i * 8)) & 0xff) {
+                wear[stat * 4 + i]++;
+            }
+        }
+        fixed[stat] = value;
+    }
+}
+
+/**
+ * @brief Prints the minimum, mean and maximum of a set of cell write counts.
+ *
+ * @param name Name of the layout.
+ * @param wear Writes to each cell.
+ * @param cells Number of cells.
+ * @param games Number of games played.
+ */
+static void wear_report(const char* name, const unsigned long* wear, unsigned int cells, long games)
+{
+    unsigned long min = wear[0];
+    unsigned long max = wear[0];
+    unsigned long total = 0;
+    unsigned int i;
+
+    for (i = 0; i < cells; i++) {
+        total += wear[i];
+        if (wear[i] < min) {
+            min = wear[i];
+        }
+        if (wear[i] > max) {
+            max = wear[i];
+        }
+    }
+
+    printf("wear %-8s %4u cells: min %6lu mean %8.1f max %6lu, worn out after %.3g games\n",
+           name, cells, min, (double)total / cells, max,
+           max ? (double)EEPROM_ENDURANCE * games / max : 0.0);
+}
+
+/**
+ * @brief Cuts the power part way through the writes of random games and
+ *        checks that every statistic afterwards has its old or new value.
+ *
+ * @param cuts Number of power cuts.
+ * @return long Number of statistics that were lost.
+ */
+static long power_cut_test(long cuts)
+{
+    uint32_t before[STATS_NUM];
+    uint32_t after[STATS_NUM];
+    uint32_t value;
+    long lost = 0;
+    long i;
+    uint8_t stat;
+
+    eeprom_erase();
+    for (i = 0; i < cuts; i++) {
+        long cut = random_next() % 24;
+        uint64_t saved_rng;
+        uint16_t saved_errors = link_errors;
+
+        // Play the game without a cut to learn the new values, then undo it.
+        for (stat = 0; stat < STATS_NUM; stat++) {
+            before[stat] = stats_get(stat);
+        }
+        saved_rng = rng;
+        {
+            uint8_t saved_eeprom[EEPROM_SIZE];
+            unsigned long saved_wear[EEPROM_SIZE];
+
+            memcpy(saved_eeprom, eeprom, sizeof(eeprom));
+            memcpy(saved_wear, eeprom_wear, sizeof(eeprom_wear));
+            play_game();
+            for (stat = 0; stat < STATS_NUM; stat++) {
+                after[stat] = stats_get(stat);
+            }
+            memcpy(eeprom, saved_eeprom, sizeof(eeprom));
+            memcpy(eeprom_wear, saved_wear, sizeof(eeprom_wear));
+        }
+        rng = saved_rng;
+        link_errors = saved_errors;
+        kvstore_init();
+
+        power_left = cut;
+        play_game();
+        power_left = -1;
+
+        // Power up again.
+        link_errors = 0;
+        stats_init();
+        for (stat = 0; stat < STATS_NUM; stat++) {
+            value = stats_get(stat);
+            if (value != before[stat] && value != after[stat]) {
+                lost++;
+            }
+        }
+    }
+    return lost;
+}
+
+int main(int argc, char** argv)
+{
+    long games = argc > 1 ? atol(argv[1]) : DEFAULT_GAMES;
+    long cuts = argc > 2 ? atol(argv[2]) : DEFAULT_POWER_CUTS;
+    uint32_t fixed[STATS_NUM] = {0};
+    unsigned long fixed_wear[STATS_NUM * 4] = {0};
+    long lost;
+    long i;
+
+    eeprom_erase();
+    scan_report("erased");
+
+    // Play until every slot has been written once.
+    while (kvstore_sequence_get() < KVSTORE_SLOTS) {
+        play_game();
+    }
+    scan_report("full");
+
+    eeprom_erase();
+    for (i = 0; i < games; i++) {
+        play_game();
+        fixed_update(fixed, fixed_wear);
+    }
+    scan_report("wrapped");
+
+    printf("%ld games: wins %u losses %u high score %u link errors %u, %u records\n",
+           games, stats_get(STATS_WINS), stats_get(STATS_LOSSES),
+           stats_get(STATS_HIGH_SCORE), stats_get(STATS_LINK_ERRORS),
+           kvstore_sequence_get());
+    wear_report("log", eeprom_wear, EEPROM_SIZE, games);
+    wear_report("fixed", fixed_wear, STATS_NUM * 4, games);
+
+    lost = power_cut_test(cuts);
+    printf("power cuts %ld: %ld statistics lost\n", cuts, lost);
+    return lost != 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file ledmat_bench.c
+ * @author Bede Nathan | nrb55
+ * @author Jaymee Chen | jch423
+ * @brief Host benchmark of ledmat_display_column with whole-port row writes against the per-pin loop.
+ * @date 2022-10-14
+ *
+ * The LED matrix driver is built twice: normally, where the rows are
+ * set with one masked port write, and with LEDMAT_ROWS_GENERIC, where
+ * each row pin is set in turn. The generic copy has its symbols renamed
+ * with a ledmat_generic_ prefix. Both are first checked to leave the
+ * scaffold's port registers the same for every pattern and column, then
+ * timed refreshing columns. On x86 the time is also given in TSC cycles.
+ *
+ * Build with "make -f Makefile.test ledmat_bench" and run as
+ * "./ledmat_bench [columns]".
+ */
+
+#include "system.h"
+#include "pio.h"
+#include "ledmat.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_COLUMNS 20000000L
+
+void ledmat_generic_init(void);
+void ledmat_generic_display_column(uint8_t pattern, uint8_t col);
+
+typedef void (*Display_column_t)(uint8_t pattern, uint8_t col);
+
+/**
+ * @brief Returns the seconds elapsed between two timestamps.
+ *
+ * @param start Start time.
+ * @param end End time.
+ * @return double elapsed seconds.
+ */
+static double elapsed_seconds(struct timespec* start, struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/**
+ * @brief Reads the x86 time stamp counter, or returns zero elsewhere.
+ *
+ * @return uint64_t Cycle count.
+ */
+static uint64_t cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Checks that both drivers set the same port registers for every pattern and column.
+ *
+ * @return int Number of mismatches.
+ */
+static int check(void)
+{
+    uint8_t fast[sizeof(SFR)];
+    int errors = 0;
+    int pattern;
+    int col;
+
+    ledmat_init();
+    ledmat_generic_init();
+    for (col = 0; col < LEDMAT_COLS_NUM; col++) {
+        for (pattern = 0; pattern < BIT(LEDMAT_ROWS_NUM); pattern++) {
+            ledmat_display_column(pattern, col);
+            memcpy(fast, &SFR, sizeof(SFR));
+            ledmat_generic_display_column(pattern, col);
+            if (memcmp(fast, &SFR, sizeof(SFR))) {
+                if (errors < 5) {
+                    printf("pattern %02x col %d: registers differ\n", pattern, col);
+                }
+                errors++;
+            }
+        }
+    }
+    return errors;
+}
+
+/**
+ * @brief Times refreshing columns with one driver.
+ *
+ * @param name Name of the driver.
+ * @param display_column The driver's ledmat_display_column.
+ * @param columns Number of columns to refresh.
+ */
+static void bench(const char* name, Display_column_t display_column, long columns)
+{
+    struct timespec start;
+    struct timespec end;
+    uint64_t start_cycles;
+    uint64_t end_cycles;
+    double seconds;
+    long i;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    start_cycles = cycles();
+    for (i = 0; i < columns; i++) {
+        display_column(i * 37, i % LEDMAT_COLS_NUM);
+    }
+    end_cycles = cycles();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = elapsed_seconds(&start, &end);
+
+    printf("%-8s %10ld columns %8.3f s %6.2f ns/column", name, columns, seconds, seconds * 1e9 / columns);
+    if (end_cycles != start_cycles) {
+        printf(" %6.1f cycles/column", (double)(end_cycles - start_cycles) / columns);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    long columns = argc > 1 ? atol(argv[1]) : DEFAULT_COLUMNS;
+    int errors;
+
+    errors = check();
+    printf("port registers checked: %d mismatches\n", errors);
+
+    bench("port", ledmat_display_column, columns);
+    bench("generic", ledmat_generic_display_column, columns);
+    return errors != 0;
+}
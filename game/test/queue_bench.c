@@ -0,0 +1,90 @@
+/**
+ * @file queue_bench.c
+ * @author Bede Nathan | nrb55
+ * @author Jaymee Chen | jch423
+ * @brief Host benchmark of ArrowQueue_t push/pop throughput.
+ * @date 2022-10-14
+ * 
+ * Build with "make -f Makefile.test queue_bench" and run as
+ * "./queue_bench [iterations]".
+ */
+
+#include "arrow.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS 10000000L
+
+/**
+ * @brief Returns the seconds elapsed between two timestamps.
+ * 
+ * @param start Start time.
+ * @param end End time.
+ * @return double elapsed seconds.
+ */
+static double elapsed_seconds(struct timespec* start, struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/**
+ * @brief Prints the throughput of one benchmark pattern.
+ * 
+ * @param name Name of the pattern.
+ * @param ops Number of push and pop operations performed.
+ * @param seconds Time taken.
+ */
+static void report(const char* name, long ops, double seconds)
+{
+    printf("%-12s %10ld ops %8.3f s %8.1f Mops/s %6.2f ns/op\n",
+           name, ops, seconds, ops / seconds * 1e-6, seconds * 1e9 / ops);
+}
+
+int main(int argc, char** argv)
+{
+    long iterations = argc > 1 ? atol(argv[1]) : DEFAULT_ITERATIONS;
+    ArrowQueue_t queue = {.head = 0, .tail = 0};
+    Arrow_t arrow = {.x = 2, .y = 1, .rotation = UP};
+    struct timespec start;
+    struct timespec end;
+    unsigned long checksum = 0;
+    long i;
+    long ops;
+
+    // Steady state: the queue sits half full and every push is matched by a pop.
+    for (i = 0; i < ARROW_QUEUE_SIZE / 2; i++) {
+        queue_append(&queue, &arrow);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++) {
+        arrow.y = i;
+        queue_append(&queue, &arrow);
+        checksum += queue_pop(&queue).y;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    report("steady", iterations * 2, elapsed_seconds(&start, &end));
+
+    // Burst: fill the queue to capacity then drain it.
+    while (!queue_is_empty(&queue)) {
+        queue_pop(&queue);
+    }
+    ops = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations / ARROW_QUEUE_SIZE; i++) {
+        while (queue_append(&queue, &arrow)) {
+            ops++;
+        }
+        while (!queue_is_empty(&queue)) {
+            checksum += queue_peek(&queue)->x;
+            queue_pop(&queue);
+            ops++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    report("fill/drain", ops, elapsed_seconds(&start, &end));
+
+    printf("queue capacity %d, %zu bytes per queue, checksum %lu\n",
+           ARROW_QUEUE_SIZE, sizeof(ArrowQueue_t), checksum);
+    return 0;
+}
@@ -0,0 +1,701 @@
+/**
+ * @file sim.c
+ * @author Bede Nathan | nrb55
+ * @author Jaymee Chen | jch423
+ * @brief Host simulator that plays two boards against each other over a virtual IR link.
+ * @date 2022-10-14
+ *
+ * The game objects are linked twice, as board0.o and board1.o, with
+ * every symbol except the renamed main made local so that each board
+ * has its own state. This file provides the drivers those objects use.
+ * Each board runs as a coroutine on a shared virtual clock: a board
+ * runs until it waits on the timer or polls an input, then the board
+ * due next runs. Each board's timer reads the virtual clock plus a
+ * random offset, as the boards were not powered up together. Nothing
+ * depends on wall-clock time, so a run is repeatable for a given
+ * script and seed.
+ *
+ * Each board has its own EEPROM, erased at the start of a run, whose
+ * writes complete at once.
+ *
+ * The navswitches and buttons follow a script of periodic presses. IR
+ * bytes take one character time at 2400 baud plus a configurable
+ * latency, and may be dropped or have bits flipped. As in the driver, a
+ * received byte equal to one the board itself sent within the last
+ * three character times is discarded as its own echo. A game is
+ * counted each time a board transmits GAMEOVER. A game in which both
+ * boards sent an arrow before receiving one, so both started as the
+ * sender, player 2, is counted as a role clash.
+ *
+ * The heap in use is measured when the first game ends and again when
+ * the run ends; the run fails if it has grown, so "./sim -g 1000"
+ * checks that the game does not leak memory from one game to the next.
+ *
+ * Build with "make -f Makefile.test sim" and run as
+ * "./sim [-g games] [-l latency_ms] [-p loss] [-f bit_flip] [-r seed]
+ * [-t stall_s] [-s script]". A script has one press per line:
+ * "board key start_ms period_ms" where key is one of N E S W P
+ * (navswitch) or B (button); lines starting with # are ignored.
+ */
+
+#include "system.h"
+#include "timer.h"
+#include "navswitch.h"
+#include "button.h"
+#include "ir_uart.h"
+#include "eeprom.h"
+#include "transmission.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <ucontext.h>
+
+#define NUM_BOARDS 2
+#define BOARD_STACK_SIZE 65536
+
+// Time for one 10-bit character at 2400 baud.
+#define BYTE_TICKS (TIMER_RATE * 10 / IR_UART_BAUD_RATE)
+
+// How long a scripted key is held down.
+#define PRESS_MS 40
+
+#define RX_QUEUE_SIZE 64
+#define EEPROM_SIZE 1024
+#define SCRIPT_SIZE 32
+#define BUTTON_KEY NAVSWITCH_PUSH + 1
+
+#define MS_TO_TICKS(MS) ((uint64_t)(MS) * TIMER_RATE / 1000)
+
+typedef struct {
+    uint64_t when;
+    uint8_t data;
+} Byte_t;
+
+typedef struct {
+    uint8_t board;
+    uint8_t key;
+    uint64_t start;
+    uint64_t period;
+} Press_t;
+
+typedef struct {
+    ucontext_t context;
+    uint64_t wake;
+    uint8_t keys_down;
+    uint8_t key_events;
+    Byte_t rx[RX_QUEUE_SIZE];
+    uint8_t rx_head;
+    uint8_t rx_tail;
+    uint64_t tx_free;
+    timer_tick_t clock_offset;
+    uint8_t echo_data;
+    uint64_t echo_time;
+    bool got_arrow;
+    bool opened;
+    uint8_t eeprom[EEPROM_SIZE];
+    unsigned long eeprom_writes;
+} Board_t;
+
+typedef struct {
+    uint64_t latency;
+    double loss;
+    double bit_flip;
+    uint64_t rng;
+    unsigned long sent;
+    unsigned long lost;
+    unsigned long corrupted;
+    unsigned long overflowed;
+    unsigned long echoed;
+} Channel_t;
+
+int board0_main(void);
+int board1_main(void);
+
+static int (*const board_mains[NUM_BOARDS])(void) = {board0_main, board1_main};
+
+static Board_t boards[NUM_BOARDS];
+static Board_t* current;
+static ucontext_t sim_context;
+static uint64_t sim_now;
+static Channel_t channel;
+static unsigned long games;
+static unsigned long clashes;
+static size_t heap_first_game;
+static uint64_t last_game;
+
+static Press_t script[SCRIPT_SIZE];
+static uint8_t script_length;
+
+static const char* default_script[] =
+{
+    "0 B 100 2000",
+    "1 P 600 700",
+    "0 P 950 700",
+    "1 N 2000 3100",
+    "0 S 2500 2900",
+    "0 E 3000 4100",
+    "1 W 3500 3700",
+};
+
+/**
+ * @brief Returns the next pseudo-random number in [0, 1). The generator
+ *        is seeded from the command line so runs are repeatable.
+ *
+ * @return double Random number.
+ */
+static double random_uniform(void)
+{
+    // xorshift64*
+    channel.rng ^= channel.rng >> 12;
+    channel.rng ^= channel.rng << 25;
+    channel.rng ^= channel.rng >> 27;
+    return ((channel.rng * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Suspends the current board until a given virtual time.
+ *
+ * @param when Virtual time to resume at.
+ */
+static void board_sleep_until(uint64_t when)
+{
+    current->wake = when;
+    swapcontext(&current->context, &sim_context);
+}
+
+/**
+ * @brief Entry point of each board's coroutine.
+ *
+ */
+static void board_entry(void)
+{
+    board_mains[current - boards]();
+
+    // The game never returns; if it does, park the board forever.
+    while (1) {
+        board_sleep_until(~0ULL);
+    }
+}
+
+/**
+ * @brief Parses one line of a script.
+ *
+ * @param line Line to parse.
+ * @return int 0 on success, -1 on a malformed line.
+ */
+static int script_add(const char* line)
+{
+    static const char keys[] = "NESWPB";
+    unsigned int board;
+    char key;
+    unsigned long start;
+    unsigned long period;
+    const char* found;
+
+    while (*line == ' ' || *line == '\t') {
+        line++;
+    }
+    if (*line == '#' || *line == '\n' || *line == '\0') {
+        return 0;
+    }
+    if (sscanf(line, " %u %c %lu %lu", &board, &key, &start, &period) != 4
+        || board >= NUM_BOARDS || !key || !(found = strchr(keys, key))
+        || script_length >= SCRIPT_SIZE) {
+        return -1;
+    }
+
+    script[script_length].board = board;
+    script[script_length].key = found - keys;
+    script[script_length].start = MS_TO_TICKS(start);
+    script[script_length].period = MS_TO_TICKS(period);
+    script_length++;
+    return 0;
+}
+
+/**
+ * @brief Loads a script file.
+ *
+ * @param filename Name of the script file.
+ * @return int 0 on success, -1 on error.
+ */
+static int script_load(const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+    char line[128];
+    int line_num = 0;
+
+    if (!file) {
+        perror(filename);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), file)) {
+        line_num++;
+        if (script_add(line) < 0) {
+            fprintf(stderr, "%s:%d: bad script line\n", filename, line_num);
+            fclose(file);
+            return -1;
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief Samples the current board's keys from the script, latching new presses.
+ *        Each poll costs one tick so that polling loops let time pass.
+ *
+ */
+static void board_keys_update(void)
+{
+    uint8_t down = 0;
+    uint8_t i;
+
+    for (i = 0; i < script_length; i++) {
+        Press_t* press = &script[i];
+
+        if (press->board == current - boards && sim_now >= press->start
+            && (sim_now - press->start) % press->period < MS_TO_TICKS(PRESS_MS)) {
+            down |= BIT(press->key);
+        }
+    }
+    current->key_events |= down & ~current->keys_down;
+    current->keys_down = down;
+
+    board_sleep_until(sim_now + 1);
+}
+
+/**
+ * @brief Returns and clears a latched key press on the current board.
+ *
+ * @param key Key number.
+ * @return true The key has been pressed since last asked.
+ */
+static bool board_key_event(uint8_t key)
+{
+    bool event = (current->key_events & BIT(key)) != 0;
+
+    current->key_events &= ~BIT(key);
+    return event;
+}
+
+/**
+ * @brief Returns true if the current board has a received byte available.
+ *
+ */
+static bool board_rx_ready(void)
+{
+    while (current->rx_head != current->rx_tail) {
+        Byte_t* byte = &current->rx[current->rx_head % RX_QUEUE_SIZE];
+
+        if (byte->when > sim_now) {
+            return false;
+        }
+        if (byte->data != current->echo_data
+            || byte->when - current->echo_time >= 3 * BYTE_TICKS) {
+            return true;
+        }
+        current->rx_head++;
+        channel.echoed++;
+    }
+    return false;
+}
+
+/**
+ * @brief Sends a byte from the current board to the other one.
+ *
+ * @param data Byte to send.
+ */
+static void board_tx(uint8_t data)
+{
+    Board_t* other = &boards[(current - boards) ^ 1];
+    Arrow_t arrow;
+    uint64_t depart;
+    uint8_t bit;
+
+    channel.sent++;
+    switch (decode_message(data, &arrow)) {
+    case MESSAGE_GAMEOVER:
+        games++;
+        last_game = sim_now;
+        if (games == 1) {
+            heap_first_game = mallinfo2().uordblks;
+        }
+        if (current->opened && other->opened) {
+            clashes++;
+        }
+        current->opened = other->opened = false;
+        current->got_arrow = other->got_arrow = false;
+        break;
+
+    case MESSAGE_ARROW:
+        if (!current->got_arrow) {
+            current->opened = true;
+        }
+        other->got_arrow = true;
+        break;
+
+    default:
+        break;
+    }
+
+    // Bytes are sent one after another at the baud rate.
+    depart = current->tx_free > sim_now ? current->tx_free : sim_now;
+    current->tx_free = depart + BYTE_TICKS;
+    current->echo_data = data;
+    current->echo_time = depart;
+
+    if (random_uniform() < channel.loss) {
+        channel.lost++;
+        return;
+    }
+    for (bit = 0; bit < 8; bit++) {
+        if (random_uniform() < channel.bit_flip) {
+            data ^= BIT(bit);
+            channel.corrupted++;
+        }
+    }
+    if ((uint8_t)(other->rx_tail - other->rx_head) >= RX_QUEUE_SIZE) {
+        channel.overflowed++;
+        return;
+    }
+    other->rx[other->rx_tail % RX_QUEUE_SIZE].when = current->tx_free + channel.latency;
+    other->rx[other->rx_tail % RX_QUEUE_SIZE].data = data;
+    other->rx_tail++;
+}
+
+void system_init(void)
+{
+}
+
+void timer_init(void)
+{
+}
+
+timer_tick_t timer_get(void)
+{
+    return sim_now + current->clock_offset;
+}
+
+timer_tick_t timer_wait_until(timer_tick_t when)
+{
+    timer_tick_t now = timer_get();
+
+    // Same wrap-around rule as the real timer.
+    if ((timer_tick_t)(now - when) < TIMER_OVERRUN_MAX) {
+        return now;
+    }
+    board_sleep_until(sim_now + (timer_tick_t)(when - now));
+    return sim_now;
+}
+
+// Nothing is shown, so the display need not be refreshed.
+void timer_periodic_start(__unused__ timer_tick_t period, __unused__ timer_callback_t callback)
+{
+}
+
+void timer_periodic_period_set(__unused__ timer_tick_t period)
+{
+}
+
+void timer_periodic_stop(void)
+{
+}
+
+void ledmat_init(void)
+{
+}
+
+void ledmat_display_column(__unused__ uint8_t pattern, __unused__ uint8_t col)
+{
+}
+
+void led_init(void)
+{
+}
+
+void led_set(__unused__ uint8_t led, __unused__ bool state)
+{
+}
+
+void navswitch_init(void)
+{
+}
+
+void navswitch_update(void)
+{
+    board_keys_update();
+}
+
+bool navswitch_push_event_p(uint8_t navswitch)
+{
+    return board_key_event(navswitch);
+}
+
+bool navswitch_event_get(navswitch_event_t* event)
+{
+    uint8_t key;
+
+    // Scripted presses are clean, so only pushes are reported.
+    for (key = 0; key <= NAVSWITCH_PUSH; key++) {
+        if (board_key_event(key)) {
+            event->time = sim_now;
+            event->navswitch = key;
+            event->pushed = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void button_init(void)
+{
+}
+
+void button_update(void)
+{
+    board_keys_update();
+}
+
+bool button_push_event_p(__unused__ uint8_t button)
+{
+    return board_key_event(BUTTON_KEY);
+}
+
+uint8_t ir_uart_init(void)
+{
+    return 1;
+}
+
+bool ir_uart_read_ready_p(void)
+{
+    return board_rx_ready();
+}
+
+int8_t ir_uart_getc(void)
+{
+    uint8_t data;
+
+    while (!ir_uart_read(&data, 1)) {
+        board_sleep_until(sim_now + 1);
+    }
+    return data;
+}
+
+uint8_t ir_uart_read(void* data, uint8_t size)
+{
+    uint8_t* dst = data;
+    uint8_t count;
+
+    for (count = 0; count < size && board_rx_ready(); count++) {
+        dst[count] = current->rx[current->rx_head % RX_QUEUE_SIZE].data;
+        current->rx_head++;
+    }
+    return count;
+}
+
+uint8_t ir_uart_write(const void* data, uint8_t size)
+{
+    const uint8_t* src = data;
+    uint8_t count;
+
+    for (count = 0; count < size; count++) {
+        board_tx(src[count]);
+    }
+    return count;
+}
+
+bool ir_uart_write_ready_p(void)
+{
+    return 1;
+}
+
+bool ir_uart_write_finished_p(void)
+{
+    return current->tx_free <= sim_now;
+}
+
+int8_t ir_uart_putc(char ch)
+{
+    board_tx(ch);
+    return 1;
+}
+
+void ir_uart_puts(const char* str)
+{
+    while (*str) {
+        board_tx(*str++);
+    }
+}
+
+eeprom_size_t eeprom_read(eeprom_addr_t addr, void* buffer, eeprom_size_t size)
+{
+    eeprom_size_t i;
+    uint8_t* data = buffer;
+
+    for (i = 0; i < size && addr < EEPROM_SIZE; i++) {
+        data[i] = current->eeprom[addr++];
+    }
+    return i;
+}
+
+eeprom_size_t eeprom_write(eeprom_addr_t addr, const void* buffer, eeprom_size_t size)
+{
+    eeprom_size_t i;
+    const uint8_t* data = buffer;
+
+    for (i = 0; i < size && addr < EEPROM_SIZE; i++) {
+        current->eeprom[addr++] = data[i];
+        current->eeprom_writes++;
+    }
+    return i;
+}
+
+eeprom_size_t eeprom_write_async(eeprom_addr_t addr, const void* buffer, eeprom_size_t size)
+{
+    eeprom_size_t i;
+    const uint8_t* data = buffer;
+
+    // Like the driver, unchanged bytes are not written.
+    for (i = 0; i < size && addr < EEPROM_SIZE; i++, addr++) {
+        if (current->eeprom[addr] != data[i]) {
+            current->eeprom[addr] = data[i];
+            current->eeprom_writes++;
+        }
+    }
+    return i;
+}
+
+bool eeprom_write_done_p(void)
+{
+    return 1;
+}
+
+void eeprom_flush(void)
+{
+}
+
+/**
+ * @brief Returns the seconds elapsed between two timestamps.
+ *
+ * @param start Start time.
+ * @param end End time.
+ * @return double elapsed seconds.
+ */
+static double elapsed_seconds(struct timespec* start, struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long target_games = 100;
+    double stall_seconds = 600;
+    const char* script_file = NULL;
+    struct timespec start;
+    struct timespec end;
+    double wall;
+    double virtual;
+    size_t heap;
+    bool stalled = false;
+    uint8_t i;
+    int opt;
+
+    channel.rng = 1;
+    while ((opt = getopt(argc, argv, "g:l:p:f:r:t:s:")) != -1) {
+        switch (opt) {
+        case 'g':
+            target_games = strtoul(optarg, NULL, 0);
+            break;
+        case 'l':
+            channel.latency = MS_TO_TICKS(atof(optarg));
+            break;
+        case 'p':
+            channel.loss = atof(optarg);
+            break;
+        case 'f':
+            channel.bit_flip = atof(optarg);
+            break;
+        case 'r':
+            channel.rng = strtoull(optarg, NULL, 0) | 1;
+            break;
+        case 't':
+            stall_seconds = atof(optarg);
+            break;
+        case 's':
+            script_file = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-g games] [-l latency_ms] [-p loss] [-f bit_flip] "
+                    "[-r seed] [-t stall_s] [-s script]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (script_file) {
+        if (script_load(script_file) < 0) {
+            return 2;
+        }
+    } else {
+        for (i = 0; i < ARRAY_SIZE(default_script); i++) {
+            script_add(default_script[i]);
+        }
+    }
+
+    for (i = 0; i < NUM_BOARDS; i++) {
+        getcontext(&boards[i].context);
+        boards[i].context.uc_stack.ss_sp = malloc(BOARD_STACK_SIZE);
+        boards[i].context.uc_stack.ss_size = BOARD_STACK_SIZE;
+        boards[i].context.uc_link = NULL;
+        memset(boards[i].eeprom, 0xff, EEPROM_SIZE);
+        boards[i].clock_offset = random_uniform() * 65536;
+        makecontext(&boards[i].context, board_entry, 0);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (games < target_games) {
+        Board_t* next = &boards[0];
+
+        // Run the board that is due first; ties go to board 0.
+        for (i = 1; i < NUM_BOARDS; i++) {
+            if (boards[i].wake < next->wake) {
+                next = &boards[i];
+            }
+        }
+        sim_now = next->wake;
+
+        if (sim_now - last_game > MS_TO_TICKS(stall_seconds * 1000)) {
+            stalled = true;
+            break;
+        }
+
+        current = next;
+        swapcontext(&sim_context, &current->context);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    heap = mallinfo2().uordblks;
+
+    wall = elapsed_seconds(&start, &end);
+    virtual = (double)sim_now / TIMER_RATE;
+    printf("games %lu in %.1f s simulated, %.3f s wall: %.1f games/s, %.0fx real time\n",
+           games, virtual, wall, games / wall, virtual / wall);
+    printf("bytes sent %lu, lost %lu, corrupted bits %lu, receive overflows %lu, echoes %lu\n",
+           channel.sent, channel.lost, channel.corrupted, channel.overflowed, channel.echoed);
+    printf("eeprom bytes written: board 0 %lu, board 1 %lu\n",
+           boards[0].eeprom_writes, boards[1].eeprom_writes);
+    printf("games with both boards player 2: %lu\n", clashes);
+    if (games) {
+        printf("heap growth since the first game: %ld bytes\n", (long)(heap - heap_first_game));
+    }
+    if (stalled) {
+        printf("stalled: no game finished in %.0f s at %.1f s\n", stall_seconds, virtual);
+        return 1;
+    }
+    if (heap > heap_first_game) {
+        printf("leak: the heap grew by %lu bytes\n", (unsigned long)(heap - heap_first_game));
+        return 1;
+    }
+    return 0;
+}
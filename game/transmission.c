@@ -12,15 +12,62 @@
 #include "transmission.h"
 #include <stdint.h>
 #include <stdbool.h>
-#include <stdio.h>
+#include <stddef.h>
 
-#define ARROW 100
-#define GAMEOVER 99
-#define ROTATION_MULT 3
+/**
+ * Every message is one byte:
+ *
+ *   bits 7:6  tag, FRAME_TAG_ARROW or FRAME_TAG_CONTROL
+ *   bits 5:2  arrow: x - 1 in bits 5:4 and rotation in bits 3:2
+ *             control: control code, or for START 1 in bit 5 and a
+ *             3-bit nonce in bits 4:2
+ *   bits 1:0  check, the XOR of the three 2-bit fields above
+ *
+ * Tags 00 and 11 are never sent, so an idle line or stuck bit reads
+ * as invalid, and any single flipped bit fails the check.
+ */
+#define FRAME_TAG_MASK 0xC0
+#define FRAME_TAG_ARROW 0x40
+#define FRAME_TAG_CONTROL 0x80
+#define FRAME_X_SHIFT 4
+#define FRAME_ROTATION_SHIFT 2
+#define FRAME_CODE_SHIFT 2
+#define FRAME_FIELD_MASK 0x3
+#define FRAME_CODE_MASK 0xF
+#define CONTROL_GAMEOVER 0
+#define CONTROL_START_ACK 1
+#define CONTROL_START 0x8
+#define CONTROL_NONCE_MASK 0x7
 #define ARROW_SUB 1
+#define ARROW_X_MAX 3
 #define POS_Y 9
 #define SCREEN_HEIGHT 8
 
+static uint16_t frame_errors = 0;
+static uint8_t start_nonce = 0;
+
+/**
+ * @brief Computes the check bits for the upper six bits of a frame.
+ * 
+ * @param frame Frame with or without its check bits.
+ * @return uint8_t The 2-bit check.
+ */
+static uint8_t frame_check(uint8_t frame)
+{
+    return ((frame >> 6) ^ (frame >> 4) ^ (frame >> 2)) & FRAME_FIELD_MASK;
+}
+
+/**
+ * @brief Adds the check bits to a frame.
+ * 
+ * @param frame Frame with its check bits clear.
+ * @return uint8_t The complete frame.
+ */
+static uint8_t frame_seal(uint8_t frame)
+{
+    return frame | frame_check(frame);
+}
+
 /**
  * @brief Encodes an arrow to an uint8_t.
  * 
@@ -29,10 +76,9 @@
  */
 uint8_t encode_arrow(Arrow_t* arrow) 
 {
-    uint8_t rotation_arrow = arrow->rotation * ROTATION_MULT;
-    uint8_t x_arrow = (arrow->x) - ARROW_SUB;
-    uint8_t encoded_arrow = rotation_arrow + x_arrow;
-    return encoded_arrow;
+    uint8_t x_arrow = (arrow->x - ARROW_SUB) << FRAME_X_SHIFT;
+    uint8_t rotation_arrow = arrow->rotation << FRAME_ROTATION_SHIFT;
+    return frame_seal(FRAME_TAG_ARROW | x_arrow | rotation_arrow);
 }
 
 /**
@@ -42,47 +88,100 @@ uint8_t encode_arrow(Arrow_t* arrow)
  */
 void transmit_arrow(Arrow_t* arrow) 
 {
-    ir_uart_putc(ARROW);
-    uint8_t encoded_arrow = encode_arrow(arrow);
-    ir_uart_putc(encoded_arrow);
-    delete_arrow(arrow);
+    ir_uart_putc(encode_arrow(arrow));
 }
 
 /**
- * @brief Decodes an encoded arrow from other transmitter and returns a new arrow pointer.
+ * @brief Decodes a received byte into a message.
  * 
- * @param encoded_arrow An encoded arrow that has been received.
- * @return Arrow_t* New arrow object that has be allocated some memory.
+ * @param frame The received byte.
+ * @param arrow Set to the decoded arrow, positioned at the top of the screen, for MESSAGE_ARROW.
+ * @return Message_t The type of message, or MESSAGE_INVALID if the byte is corrupt.
  */
-Arrow_t* decode_arrow(uint8_t encoded_arrow) 
+Message_t decode_message(uint8_t frame, Arrow_t* arrow)
 {
-    Rotation_t rotation = encoded_arrow / ROTATION_MULT;
-    uint8_t x = encoded_arrow % ROTATION_MULT + ARROW_SUB;
-    Arrow_t* arrow = new_arrow(x, POS_Y, rotation);
-    return arrow;
+    uint8_t x_arrow;
+    uint8_t code;
+
+    if ((frame & FRAME_FIELD_MASK) != frame_check(frame)) {
+        return MESSAGE_INVALID;
+    }
+
+    switch (frame & FRAME_TAG_MASK) {
+    case FRAME_TAG_ARROW:
+        x_arrow = ((frame >> FRAME_X_SHIFT) & FRAME_FIELD_MASK) + ARROW_SUB;
+        if (x_arrow > ARROW_X_MAX) {
+            return MESSAGE_INVALID;
+        }
+        arrow->x = x_arrow;
+        arrow->y = POS_Y;
+        arrow->rotation = (frame >> FRAME_ROTATION_SHIFT) & FRAME_FIELD_MASK;
+        return MESSAGE_ARROW;
+
+    case FRAME_TAG_CONTROL:
+        code = (frame >> FRAME_CODE_SHIFT) & FRAME_CODE_MASK;
+        if (code & CONTROL_START) {
+            return MESSAGE_START;
+        }
+        switch (code) {
+        case CONTROL_GAMEOVER:
+            return MESSAGE_GAMEOVER;
+
+        case CONTROL_START_ACK:
+            return MESSAGE_START_ACK;
+
+        default:
+            return MESSAGE_INVALID;
+        }
+
+    default:
+        return MESSAGE_INVALID;
+    }
 }
 
 /**
- * @brief Receives an arrow.
+ * @brief Receives a message if one is waiting. Corrupt bytes are counted and discarded.
  * 
- * @return Arrow_t* The new received arrow pointer.
+ * @param arrow Set to the received arrow for MESSAGE_ARROW.
+ * @return Message_t The type of message received, or MESSAGE_NONE.
  */
-Arrow_t* receive_arrow(void) 
+Message_t receive_message(Arrow_t* arrow)
 {
-    uint8_t encoded_arrow = ir_uart_getc();
-    Arrow_t* new_arrow = decode_arrow(encoded_arrow);
+    Message_t message;
+    uint8_t frame;
+
+    if (!ir_uart_read_ready_p()) {
+        return MESSAGE_NONE;
+    }
+
+    frame = ir_uart_getc();
+    message = decode_message(frame, arrow);
+    if (message == MESSAGE_INVALID) {
+        frame_errors++;
+    } else if (message == MESSAGE_START) {
+        start_nonce = (frame >> FRAME_CODE_SHIFT) & CONTROL_NONCE_MASK;
+    }
+    return message;
+}
 
-    return new_arrow;
+/**
+ * @brief Returns the nonce carried by the last START received.
+ * 
+ * @return uint8_t Nonce, 0 to START_NONCE_MAX.
+ */
+uint8_t transmission_start_nonce(void)
+{
+    return start_nonce;
 }
 
 /**
- * @brief Returns greater true when there is data to be received.
+ * @brief Returns the number of corrupt bytes received.
  * 
- * @return bool true when nothing in buffer, false when there is something to be received.
+ * @return uint16_t Number of bytes rejected by receive_message.
  */
-bool recieve_ready(void) 
+uint16_t transmission_error_count(void)
 {
-    return ir_uart_read_ready_p();
+    return frame_errors;
 }
 
 /**
@@ -91,53 +190,41 @@ bool recieve_ready(void)
  */
 void transmit_game_over(void) 
 {
-    ir_uart_putc(GAMEOVER);
+    ir_uart_putc(frame_seal(FRAME_TAG_CONTROL | (CONTROL_GAMEOVER << FRAME_CODE_SHIFT)));
 }
 
 /**
- * @brief Returns true if the other player has sent a GAMEOVER message.
+ * @brief Transmit to the other player that a game has been started and they are player 2.
  * 
- * @return true Game is over and player has won.
- * @return false Game is still playing.
+ * @param nonce Nonce, 0 to START_NONCE_MAX, used to settle a START sent by both boards at once.
  */
-bool is_gameover(void)
-{   
-    char type = ARROW;
-    if (recieve_ready()) {
-        type = ir_uart_getc();
-    }
-    return type == GAMEOVER;
+void transmit_start(uint8_t nonce)
+{
+    uint8_t code = CONTROL_START | (nonce & CONTROL_NONCE_MASK);
+
+    ir_uart_putc(frame_seal(FRAME_TAG_CONTROL | (code << FRAME_CODE_SHIFT)));
 }
 
 /**
- * @brief Transmission task for the sender.
+ * @brief Transmit to the other player that their START was received and this board is player 2.
  * 
- * @param outgoing_queue The queue of arrows that are needing to be sent.
  */
-void sender_transmission (ArrowQueue_t* outgoing_queue)
+void transmit_start_ack(void)
 {
-    Node_t* node = outgoing_queue->head;
-    Arrow_t* arrow;
-    if (node != NULL) {
-        arrow = node->arrow;
-
-        if (arrow->y > SCREEN_HEIGHT) {
-            arrow = queue_pop(outgoing_queue);
-            transmit_arrow(arrow);
-        }
-    }
+    ir_uart_putc(frame_seal(FRAME_TAG_CONTROL | (CONTROL_START_ACK << FRAME_CODE_SHIFT)));
 }
 
 /**
- * @brief Transmission task for the receiver.
+ * @brief Transmission task for the sender.
  * 
- * @param incoming_queue The incoming queue of arrows the player needs to match.
+ * @param outgoing_queue The queue of arrows that are needing to be sent.
  */
-void receiver_transmission (ArrowQueue_t* incoming_queue)
+void sender_transmission (ArrowQueue_t* outgoing_queue)
 {
-    Arrow_t* arrow;
-    if (recieve_ready()) {
-        arrow = receive_arrow();
-        queue_append(incoming_queue, arrow);
+    Arrow_t* arrow = queue_peek(outgoing_queue);
+
+    if (arrow != NULL && arrow->y > SCREEN_HEIGHT) {
+        Arrow_t outgoing_arrow = queue_pop(outgoing_queue);
+        transmit_arrow(&outgoing_arrow);
     }
-}
\ No newline at end of file
+}
@@ -7,10 +7,32 @@
  * 
  */
 
+#ifndef TRANSMISSION_H
+#define TRANSMISSION_H
+
 #include "arrow.h"
 #include <stdint.h>
 #include <stdbool.h>
 
+typedef enum {
+    MESSAGE_NONE,
+    MESSAGE_INVALID,
+    MESSAGE_ARROW,
+    MESSAGE_GAMEOVER,
+    MESSAGE_START,
+    MESSAGE_START_ACK
+} Message_t;
+
+#define START_NONCE_MAX 7
+
+/**
+ * @brief Encodes an arrow to an uint8_t.
+ * 
+ * @param arrow Arrow to be incoded for transmission.
+ * @return uint8_t Encoded value of the arrow.
+ */
+uint8_t encode_arrow(Arrow_t* arrow);
+
 /**
  * @brief Transmits an arrow to the other device.
  * 
@@ -19,11 +41,35 @@
 void transmit_arrow(Arrow_t* arrow);
 
 /**
- * @brief Receives an arrow.
+ * @brief Decodes a received byte into a message.
+ * 
+ * @param frame The received byte.
+ * @param arrow Set to the decoded arrow, positioned at the top of the screen, for MESSAGE_ARROW.
+ * @return Message_t The type of message, or MESSAGE_INVALID if the byte is corrupt.
+ */
+Message_t decode_message(uint8_t frame, Arrow_t* arrow);
+
+/**
+ * @brief Receives a message if one is waiting. Corrupt bytes are counted and discarded.
+ * 
+ * @param arrow Set to the received arrow for MESSAGE_ARROW.
+ * @return Message_t The type of message received, or MESSAGE_NONE.
+ */
+Message_t receive_message(Arrow_t* arrow);
+
+/**
+ * @brief Returns the nonce carried by the last START received.
  * 
- * @return Arrow_t* The new received arrow pointer.
+ * @return uint8_t Nonce, 0 to START_NONCE_MAX.
  */
-Arrow_t* receive_arrow(void);
+uint8_t transmission_start_nonce(void);
+
+/**
+ * @brief Returns the number of corrupt bytes received.
+ * 
+ * @return uint16_t Number of bytes rejected by receive_message.
+ */
+uint16_t transmission_error_count(void);
 
 /**
  * @brief Transmit that the game has been lost to the other player.
@@ -32,23 +78,23 @@ Arrow_t* receive_arrow(void);
 void transmit_game_over(void);
 
 /**
- * @brief Returns true if the other player has sent a GAMEOVER message.
+ * @brief Transmit to the other player that a game has been started and they are player 2.
  * 
- * @return true Game is over and player has won.
- * @return false Game is still playing.
+ * @param nonce Nonce, 0 to START_NONCE_MAX, used to settle a START sent by both boards at once.
  */
-bool is_gameover(void);
+void transmit_start(uint8_t nonce);
 
 /**
- * @brief Transmission task for the sender.
+ * @brief Transmit to the other player that their START was received and this board is player 2.
  * 
- * @param outgoing_queue The queue of arrows that are needing to be sent.
  */
-void sender_transmission (ArrowQueue_t* outgoing_queue);
+void transmit_start_ack(void);
 
 /**
- * @brief Transmission task for the receiver.
+ * @brief Transmission task for the sender.
  * 
- * @param incoming_queue The incoming queue of arrows the player needs to match.
+ * @param outgoing_queue The queue of arrows that are needing to be sent.
  */
-void receiver_transmission (ArrowQueue_t* incoming_queue);
\ No newline at end of file
+void sender_transmission (ArrowQueue_t* outgoing_queue);
+
+#endif
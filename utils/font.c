@@ -7,19 +7,46 @@
 #include "font.h"
 
 
-/** Determine if character in font.
+/** Find the element data for a character.
     @param font pointer to font structure
-    @param ch character to check
-    @return non-zero if character is in font.  */
-bool font_contains_p (font_t *font, char ch)
+    @param ch character to find
+    @return pointer to element data or 0 if character not in font.  */
+static font_data_t *font_element (font_t *font, char ch)
 {
     int8_t index;
+    uint8_t i;
 
     if (!font)
         return 0;
 
+    if (font->flags & FONT_SUBSET)
+    {
+        /* Subsets are small, so search the table in order.  */
+        for (i = 0; i < font->size; i++)
+        {
+            if (font->data[i] == (uint8_t) ch)
+                return &font->data[font->size + i * font->bytes];
+            if (font->data[i] > (uint8_t) ch)
+                break;
+        }
+        return 0;
+    }
+
     index = ch - font->offset;
-    return index >= 0 && index < font->size;
+    if (index < 0 || index >= font->size)
+        return 0;
+
+    return &font->data[index * font->bytes];
+}
+
+
+/** Determine if character in font.
+    @param font pointer to font structure
+    @param ch character to check
+    @return non-zero if character is in font.  */
+bool font_contains_p (font_t *font, char ch)
+{
+    return font_element (font, ch) != 0;
 }
 
 
@@ -31,7 +58,6 @@ bool font_contains_p (font_t *font, char ch)
     @return 1 if pixel on; if pixel out of bounds return 0.  */
 bool font_pixel_get (font_t *font, char ch, uint8_t col, uint8_t row)
 {
-    int8_t index;
     font_data_t *char_data;
     uint8_t offset;
 
@@ -42,16 +68,85 @@ bool font_pixel_get (font_t *font, char ch, uint8_t col, uint8_t row)
     if (col >= font->width || row >= font->height)
         return 0;
 
-    /* Find index of font element.  */
-    index = ch - font->offset;
-    if (index < 0 || index >= font->size)
+    /* Get start of font element data for ch.  */
+    char_data = font_element (font, ch);
+    if (!char_data)
         return 0;
 
-    /* Get start of font element data for ch.  */
-    char_data = &font->data[index * font->bytes];
+    if (font->flags & FONT_COLUMNS)
+        return (char_data[col] & BIT (row)) != 0;
 
     /* Extract whether pixel should be on or off.  */
     offset = row * font->width + col;
     return (char_data[offset >> 3] & BIT (offset % 8)) != 0;
 }
 
+
+/** Get the pixels of a font element as column bit patterns.  This
+    walks the element data once rather than looking up each pixel.
+    @param font pointer to font structure
+    @param ch character to get
+    @param columns array of font->width bytes to fill, one per column
+    with bit 0 the top row
+    @return 1 if character is in font; otherwise the columns are
+    cleared and 0 is returned.  */
+bool font_columns_get (font_t *font, char ch, uint8_t *columns)
+{
+    font_data_t *char_data;
+    uint8_t bits = 0;
+    uint8_t bitmask = 0;
+    uint8_t col;
+    uint8_t row;
+
+    if (!font)
+        return 0;
+
+    char_data = font_element (font, ch);
+
+    /* Column-major elements are already in the display's layout.  */
+    if (font->flags & FONT_COLUMNS)
+    {
+        for (col = 0; col < font->width; col++)
+            columns[col] = char_data ? char_data[col] : 0;
+        return char_data != 0;
+    }
+
+    for (col = 0; col < font->width; col++)
+        columns[col] = 0;
+
+    if (!char_data)
+        return 0;
+
+    /* The element is stored a row at a time, least significant bit
+       first, so step through the bits in order.  */
+    for (row = 0; row < font->height; row++)
+    {
+        for (col = 0; col < font->width; col++)
+        {
+            if (!bitmask)
+            {
+                bits = *char_data++;
+                bitmask = 1;
+            }
+            if (bits & bitmask)
+                columns[col] |= BIT (row);
+            bitmask <<= 1;
+        }
+    }
+    return 1;
+}
+
+
+/** Get the columns of an element of a column-major font without
+    copying them.
+    @param font pointer to a font with FONT_COLUMNS set
+    @param ch character to get
+    @return pointer to font->width bytes, or 0 if the character is not
+    in the font or the font is not column-major.  */
+font_data_t *font_columns (font_t *font, char ch)
+{
+    if (!font || !(font->flags & FONT_COLUMNS))
+        return 0;
+
+    return font_element (font, ch);
+}
@@ -11,16 +11,33 @@
 
 typedef const uint8_t font_data_t;
 
+
+/** Font flags, describing how the font elements are stored.  */
+enum
+{
+    /** Each element is bit-packed a row at a time, least significant
+        bit first.  */
+    FONT_PACKED = 1,
+    /** Each element is one byte per column with bit 0 the top row,
+        as drawn on the display.  The height is at most 8.  */
+    FONT_COLUMNS = 2,
+    /** Only some characters are present.  The data starts with a
+        table of the size characters in ascending order, followed by
+        their elements in the same order.  */
+    FONT_SUBSET = 4
+};
+
+
 /** Font structure.  */
 typedef const struct
 {
-    /** Flags for future options.  */
+    /** Storage flags; see FONT_PACKED.  */
     uint8_t flags;
     /** Width of font element.  */
     uint8_t width;
     /** Height of font element.  */
     uint8_t height;
-    /** Index of first entry in font.  */
+    /** Index of first entry in font (unused for a subset).  */
     uint8_t offset;
     /** Number of font entries in table.  */
     uint8_t size;
@@ -47,4 +64,26 @@ bool font_contains_p (font_t *font, char ch);
 bool
 font_pixel_get (font_t *font, char ch, uint8_t col, uint8_t row);
 
+
+/** Get the pixels of a font element as column bit patterns.
+    @param font pointer to font structure
+    @param ch character to get
+    @param columns array of font->width bytes to fill, one per column
+    with bit 0 the top row
+    @return 1 if character is in font; otherwise the columns are
+    cleared and 0 is returned.  */
+bool
+font_columns_get (font_t *font, char ch, uint8_t *columns);
+
+
+/** Get the columns of an element of a column-major font without
+    copying them.
+    @param font pointer to a font with FONT_COLUMNS set
+    @param ch character to get
+    @return pointer to font->width bytes, one per column with bit 0
+    the top row, or 0 if the character is not in the font or the font
+    is not column-major.  */
+font_data_t *
+font_columns (font_t *font, char ch);
+
 #endif
@@ -0,0 +1,244 @@
+/** @file   kvstore.c
+    @author M. P. Hayes, UCECE
+    @date   17 October 2022
+    @brief  Wear-levelled key/value store in EEPROM.
+*/
+#include "system.h"
+#include "eeprom.h"
+#include "kvstore.h"
+
+
+/* Record layout; multi-byte fields are little endian.  */
+enum
+{
+    KVSTORE_SEQ = 0,
+    KVSTORE_KEY = 2,
+    KVSTORE_VALUE = 3,
+    KVSTORE_CRC = 7
+};
+
+/* Index value for a key with no record.  */
+#define KVSTORE_NONE 0xff
+
+
+/* Slot holding the newest record for each key.  */
+static uint8_t kvstore_index[KVSTORE_KEYS_NUM];
+
+/* Value of each key, so that getting a value does not read the
+   EEPROM and wait for a write in progress.  */
+static uint32_t kvstore_value[KVSTORE_KEYS_NUM];
+
+/* Slot to write next and the sequence number of the newest record.  */
+static uint8_t kvstore_head;
+static uint16_t kvstore_seq;
+
+
+/* CRC-8 with polynomial x^8 + x^2 + x + 1.  Starting from 0xff
+   means a record of zeros is not valid.  */
+static uint8_t
+kvstore_crc (const uint8_t *data, uint8_t size)
+{
+    uint8_t crc = 0xff;
+    uint8_t i;
+    uint8_t bit;
+
+    for (i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        for (bit = 0; bit < 8; bit++)
+            crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+
+static eeprom_addr_t
+kvstore_addr (uint8_t slot)
+{
+    return KVSTORE_START + (eeprom_addr_t) slot * KVSTORE_RECORD_SIZE;
+}
+
+
+/* Read a record, returning non-zero if it is valid.  */
+static bool
+kvstore_record_read (uint8_t slot, uint8_t *record)
+{
+    eeprom_read (kvstore_addr (slot), record, KVSTORE_RECORD_SIZE);
+
+    return record[KVSTORE_KEY] < KVSTORE_KEYS_NUM
+        && record[KVSTORE_CRC] == kvstore_crc (record, KVSTORE_CRC);
+}
+
+
+static uint16_t
+kvstore_record_seq (const uint8_t *record)
+{
+    return record[KVSTORE_SEQ] | (record[KVSTORE_SEQ + 1] << 8);
+}
+
+
+/* Write a record at the head of the log.  */
+static void
+kvstore_record_write (kvstore_key_t key, uint32_t value)
+{
+    uint8_t record[KVSTORE_RECORD_SIZE];
+    eeprom_size_t written;
+    uint8_t i;
+
+    kvstore_seq++;
+    record[KVSTORE_SEQ] = kvstore_seq;
+    record[KVSTORE_SEQ + 1] = kvstore_seq >> 8;
+    record[KVSTORE_KEY] = key;
+    for (i = 0; i < 4; i++)
+        record[KVSTORE_VALUE + i] = value >> (i * 8);
+    record[KVSTORE_CRC] = kvstore_crc (record, KVSTORE_CRC);
+
+    /* Only wait for the EEPROM if its write queue is full.  */
+    written = 0;
+    while (1)
+    {
+        written += eeprom_write_async (kvstore_addr (kvstore_head) + written,
+                                       record + written,
+                                       KVSTORE_RECORD_SIZE - written);
+        if (written >= KVSTORE_RECORD_SIZE)
+            break;
+        eeprom_flush ();
+    }
+
+    kvstore_index[key] = kvstore_head;
+    kvstore_value[key] = value;
+    kvstore_head++;
+    if (kvstore_head >= KVSTORE_SLOTS)
+        kvstore_head = 0;
+}
+
+
+/** Scan the EEPROM and build the index.  */
+void
+kvstore_init (void)
+{
+    uint8_t record[KVSTORE_RECORD_SIZE];
+    uint16_t key_seq[KVSTORE_KEYS_NUM];
+    uint16_t seq;
+    bool found = 0;
+    uint8_t slot;
+    uint8_t newest = 0;
+    uint8_t i;
+
+    for (slot = 0; slot < KVSTORE_KEYS_NUM; slot++)
+    {
+        kvstore_index[slot] = KVSTORE_NONE;
+        key_seq[slot] = 0;
+    }
+
+    for (slot = 0; slot < KVSTORE_SLOTS; slot++)
+    {
+        kvstore_key_t key;
+
+        if (!kvstore_record_read (slot, record))
+            continue;
+
+        /* All the valid records are within KVSTORE_SLOTS of each other,
+           so sequence numbers can be compared by their difference even
+           after they wrap.  */
+        seq = kvstore_record_seq (record);
+        if (!found || (int16_t) (seq - kvstore_seq) > 0)
+        {
+            kvstore_seq = seq;
+            newest = slot;
+        }
+        found = 1;
+
+        key = record[KVSTORE_KEY];
+        if (kvstore_index[key] == KVSTORE_NONE
+            || (int16_t) (seq - key_seq[key]) > 0)
+        {
+            kvstore_index[key] = slot;
+            key_seq[key] = seq;
+            kvstore_value[key] = 0;
+            for (i = 0; i < 4; i++)
+                kvstore_value[key] |= (uint32_t) record[KVSTORE_VALUE + i] << (i * 8);
+        }
+    }
+
+    kvstore_head = 0;
+    if (found)
+    {
+        kvstore_head = newest + 1;
+        if (kvstore_head >= KVSTORE_SLOTS)
+            kvstore_head = 0;
+    }
+}
+
+
+/** Get a value.  */
+bool
+kvstore_get (kvstore_key_t key, uint32_t *value)
+{
+    if (key >= KVSTORE_KEYS_NUM || kvstore_index[key] == KVSTORE_NONE)
+        return 0;
+
+    *value = kvstore_value[key];
+    return 1;
+}
+
+
+/* Return the key whose newest record is in SLOT, or KVSTORE_NONE.  */
+static uint8_t
+kvstore_slot_owner (uint8_t slot)
+{
+    uint8_t key;
+
+    for (key = 0; key < KVSTORE_KEYS_NUM; key++)
+    {
+        if (kvstore_index[key] == slot)
+            return key;
+    }
+    return KVSTORE_NONE;
+}
+
+
+/** Set a value.  */
+bool
+kvstore_set (kvstore_key_t key, uint32_t value)
+{
+    uint32_t old;
+    uint8_t next;
+    uint8_t owner;
+
+    if (key >= KVSTORE_KEYS_NUM)
+        return 0;
+
+    if (kvstore_get (key, &old) && old == value)
+        return 1;
+
+    /* The head slot never holds a live record.  The slot after it must
+       not either, since it becomes the head, so move a live record
+       there to the head first.  Its old copy stays valid until the
+       new one is written.  There is no need to move the record being
+       replaced.  */
+    while (1)
+    {
+        next = kvstore_head + 1;
+        if (next >= KVSTORE_SLOTS)
+            next = 0;
+
+        owner = kvstore_slot_owner (next);
+        if (owner == KVSTORE_NONE || owner == key)
+            break;
+
+        kvstore_get (owner, &old);
+        kvstore_record_write (owner, old);
+    }
+
+    kvstore_record_write (key, value);
+    return 1;
+}
+
+
+/** Get the sequence number of the newest record.  */
+uint16_t
+kvstore_sequence_get (void)
+{
+    return kvstore_seq;
+}
@@ -0,0 +1,112 @@
+/** @file   kvstore.h
+    @author M. P. Hayes, UCECE
+    @date   17 October 2022
+    @brief  Wear-levelled key/value store in EEPROM.
+
+    @defgroup kvstore Key/value store
+
+    This module keeps a few 32-bit values in EEPROM, for example high
+    scores or counts of games played, without wearing out the cells
+    that hold them.  The EEPROM is used as a circular log of fixed-size
+    records.  Setting a value appends a record, so successive writes
+    of the same key go to different cells and every cell is written
+    equally often.
+
+    Each record holds a sequence number, the key, the value, and a
+    CRC-8.  kvstore_init reads every record once to find the newest
+    record for each key and where the log ends; records with a bad CRC,
+    say from a write cut short by a reset, are ignored.  A CRC-8 lets
+    about one in 256 such records through.
+
+    Only superseded records are ever overwritten.  The slot after the
+    head of the log is kept free of live records: when the head is
+    about to reach a value that has not changed for a lap of the log,
+    that record is first copied to the head.  This compacts the log as
+    it goes, and a reset part way through leaves the old copy in place.
+
+    The values are also kept in RAM, 4 bytes per key, so only
+    kvstore_init reads the EEPROM.  Writes use eeprom_write_async so
+    they do not hold up the program, unless the EEPROM write queue
+    fills.
+
+    @code
+    #include "kvstore.h"
+
+    enum {KEY_GAMES};
+
+    void main (void)
+    {
+        uint32_t games = 0;
+
+        system_init ();
+        kvstore_init ();
+
+        kvstore_get (KEY_GAMES, &games);
+        kvstore_set (KEY_GAMES, games + 1);
+    }
+    @endcode
+*/
+#ifndef KVSTORE_H
+#define KVSTORE_H
+
+#include "system.h"
+
+
+/** First EEPROM address used.  */
+#ifndef KVSTORE_START
+#define KVSTORE_START 0
+#endif
+
+/** Number of EEPROM bytes used, a multiple of KVSTORE_RECORD_SIZE.  */
+#ifndef KVSTORE_SIZE
+#define KVSTORE_SIZE 1024
+#endif
+
+/** Number of keys; keys are 0 to KVSTORE_KEYS_NUM - 1.  */
+#ifndef KVSTORE_KEYS_NUM
+#define KVSTORE_KEYS_NUM 8
+#endif
+
+/** Bytes per record: sequence number, key, value, and CRC.  */
+#define KVSTORE_RECORD_SIZE 8
+
+/** Number of records in the log.  */
+#define KVSTORE_SLOTS (KVSTORE_SIZE / KVSTORE_RECORD_SIZE)
+
+#if KVSTORE_SLOTS > 255
+#error KVSTORE_SIZE is too big
+#endif
+
+#if KVSTORE_SLOTS < KVSTORE_KEYS_NUM + 2
+#error KVSTORE_SIZE is too small for KVSTORE_KEYS_NUM
+#endif
+
+
+typedef uint8_t kvstore_key_t;
+
+
+/** Scan the EEPROM and build the index.  This must be called before
+    the other functions.  */
+void kvstore_init (void);
+
+
+/** Get a value.
+    @param key key to look up
+    @param value pointer to where to store the value
+    @return non-zero if the key has a value, otherwise value is
+    unchanged.  */
+bool kvstore_get (kvstore_key_t key, uint32_t *value);
+
+
+/** Set a value.  Nothing is written if the value is unchanged.
+    @param key key to set
+    @param value new value
+    @return non-zero for success, zero if the key is out of range.  */
+bool kvstore_set (kvstore_key_t key, uint32_t value);
+
+
+/** Get the sequence number of the newest record.  This counts the
+    records written and is only useful for statistics.  */
+uint16_t kvstore_sequence_get (void);
+
+#endif
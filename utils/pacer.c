@@ -9,6 +9,10 @@
 
 static timer_tick_t pacer_period;
 
+#ifdef PROFILE_ENABLE
+static uint16_t pacer_overruns;
+#endif
+
 
 /** Initialise pacer:
     @param pacer_rate rate in Hz.  */
@@ -25,6 +29,29 @@ void pacer_wait (void)
 {
     static timer_tick_t when = 0;
 
+#ifdef PROFILE_ENABLE
+    static bool started = 0;
+    timer_tick_t late;
+
+    /* The loop has overrun if the tick has already passed.  The first
+       call has no tick to miss since none has been set yet.  */
+    late = timer_get () - when;
+    if (started && late != 0 && late < TIMER_OVERRUN_MAX)
+        pacer_overruns++;
+    started = 1;
+#endif
+
     timer_wait_until (when);
     when += pacer_period;
 }
+
+
+#ifdef PROFILE_ENABLE
+/** Get the number of times pacer_wait was called after the tick it
+    should have waited for.
+    @return number of overruns.  */
+uint16_t pacer_overruns_get (void)
+{
+    return pacer_overruns;
+}
+#endif
@@ -43,4 +43,12 @@ extern void pacer_wait (void);
     @param pacer_rate rate in Hz.  */
 extern void pacer_init (pacer_rate_t pacer_rate);
 
+#ifdef PROFILE_ENABLE
+/** Get the number of times pacer_wait was called after the tick it
+    should have waited for.
+    @return number of overruns.  */
+extern uint16_t pacer_overruns_get (void);
+#endif
+
+
 #endif /* PACER_H  */
@@ -0,0 +1,119 @@
+/** @file   profile.c
+    @author M. P. Hayes, UCECE
+    @date   17 October 2022
+    @brief  Execution time profiling.
+*/
+#include "system.h"
+#include "profile.h"
+
+#ifdef PROFILE_ENABLE
+
+#ifndef __AVR__
+#include <stdio.h>
+#endif
+
+
+/** Record one run.
+    @param profile pointer to statistics to update
+    @param ticks time the run took.  */
+void profile_record (profile_t *profile, timer_tick_t ticks)
+{
+    uint8_t bin;
+    timer_tick_t rest;
+
+    if (ticks < profile->min)
+        profile->min = ticks;
+    if (ticks > profile->max)
+        profile->max = ticks;
+
+    profile->count++;
+    profile->total += ticks;
+
+    /* The bin is the number of significant bits.  */
+    bin = 0;
+    for (rest = ticks; rest && bin < PROFILE_BINS - 1; rest >>= 1)
+        bin++;
+
+    if (profile->bins[bin] != (uint16_t) ~0)
+        profile->bins[bin]++;
+}
+
+
+/** Record how late one run started.
+    @param profile pointer to statistics to update
+    @param ticks time between when the run was due and when it started.  */
+void profile_late_record (profile_t *profile, timer_tick_t ticks)
+{
+    if (ticks < profile->late_min)
+        profile->late_min = ticks;
+    if (ticks > profile->late_max)
+        profile->late_max = ticks;
+}
+
+
+/** Get the mean run time.
+    @param profile pointer to statistics
+    @return mean time in ticks or zero if there have been no runs.  */
+timer_tick_t profile_mean (const profile_t *profile)
+{
+    if (!profile->count)
+        return 0;
+
+    return profile->total / profile->count;
+}
+
+
+/** Clear the statistics, keeping the name.
+    @param profile pointer to statistics to clear.  */
+void profile_reset (profile_t *profile)
+{
+    uint8_t i;
+
+    profile->min = ~0;
+    profile->max = 0;
+    profile->count = 0;
+    profile->total = 0;
+    profile->late_min = ~0;
+    profile->late_max = 0;
+    for (i = 0; i < PROFILE_BINS; i++)
+        profile->bins[i] = 0;
+}
+
+
+#ifndef __AVR__
+
+/** Print a heading for profile_print (host only).  */
+void profile_print_heading (void)
+{
+    uint8_t i;
+
+    fprintf (stderr, "%-12s %8s %6s %6s %6s %6s %6s %8s  histogram (ticks <",
+             "task", "runs", "min", "mean", "max", "late", "jitter", "overruns");
+    for (i = 0; i < PROFILE_BINS - 1; i++)
+        fprintf (stderr, " %u", 1u << i);
+    fprintf (stderr, " more)  1 tick = %.1f us\n", 1e6 / TIMER_RATE);
+}
+
+
+/** Print the statistics on one line to stderr (host only).
+    @param profile pointer to statistics
+    @param overruns number of missed deadlines to print.  */
+void profile_print (const profile_t *profile, uint16_t overruns)
+{
+    uint8_t i;
+
+    fprintf (stderr, "%-12s %8lu %6u %6u %6u %6u %6u %8u ",
+             profile->name ? profile->name : "?",
+             (unsigned long) profile->count,
+             profile->count ? profile->min : 0,
+             profile_mean (profile), profile->max, profile->late_max,
+             profile->count ? profile->late_max - profile->late_min : 0,
+             overruns);
+    for (i = 0; i < PROFILE_BINS; i++)
+        fprintf (stderr, " %u", profile->bins[i]);
+    fprintf (stderr, "\n");
+}
+
+#endif
+
+#endif
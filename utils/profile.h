@@ -0,0 +1,133 @@
+/** @file   profile.h
+    @author M. P. Hayes, UCECE
+    @date   17 October 2022
+    @brief  Execution time profiling.
+
+    @defgroup profile Execution time profiling
+
+    This module records how long a section of code takes to run,
+    measured in timer ticks.  For each profiled section it keeps the
+    minimum, maximum, and mean time and a histogram where bin n counts
+    the runs that took between 2^(n-1) and 2^n - 1 ticks (bin 0 counts
+    runs of zero ticks and the last bin collects everything longer).
+
+    Code that is meant to start at a given time, such as a scheduled
+    task, can also record how late each run started with PROFILE_LATE.
+    The spread between the least and most late starts is the jitter.
+
+    Profiling is only compiled when PROFILE_ENABLE is defined.
+    Otherwise PROFILE_START and PROFILE_STOP expand to nothing and
+    profile_t is not used.  The task scheduler profiles each task this
+    way, see task.h.
+
+    @code
+    #include "profile.h"
+
+    static profile_t update_profile = PROFILE_INIT ("update");
+
+    void update (void)
+    {
+        PROFILE_START (&update_profile);
+        // Do something.
+        PROFILE_STOP (&update_profile);
+    }
+    @endcode
+*/
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "system.h"
+#include "timer.h"
+
+
+/** Number of histogram bins.  */
+#ifndef PROFILE_BINS
+#define PROFILE_BINS 8
+#endif
+
+
+/** Execution time statistics for one profiled section.  */
+typedef struct profile_struct
+{
+    /** Name to print.  */
+    const char *name;
+    /** When the current run started.  */
+    timer_tick_t start;
+    /** Shortest run in ticks.  */
+    timer_tick_t min;
+    /** Longest run in ticks.  */
+    timer_tick_t max;
+    /** Number of runs.  */
+    uint32_t count;
+    /** Sum of run times in ticks.  */
+    uint32_t total;
+    /** Log2 histogram of run times; the bins saturate.  */
+    uint16_t bins[PROFILE_BINS];
+    /** Least late start in ticks.  */
+    timer_tick_t late_min;
+    /** Most late start in ticks.  */
+    timer_tick_t late_max;
+} profile_t;
+
+
+/** Initialiser for a named profile_t.  */
+#define PROFILE_INIT(NAME) \
+    {.name = (NAME), .min = (timer_tick_t) ~0, .late_min = (timer_tick_t) ~0}
+
+
+#ifdef PROFILE_ENABLE
+
+/** Mark the start of a profiled section.  */
+#define PROFILE_START(PROFILE) ((PROFILE)->start = timer_get ())
+
+/** Mark the end of a profiled section and record its time.  */
+#define PROFILE_STOP(PROFILE) \
+    profile_record ((PROFILE), timer_get () - (PROFILE)->start)
+
+/** Record how late the current run started after PROFILE_START,
+    given the time DUE it should have started.  */
+#define PROFILE_LATE(PROFILE, DUE) \
+    profile_late_record ((PROFILE), (PROFILE)->start - (DUE))
+
+#else
+
+#define PROFILE_START(PROFILE)
+#define PROFILE_STOP(PROFILE)
+#define PROFILE_LATE(PROFILE, DUE)
+
+#endif
+
+
+/** Record one run.
+    @param profile pointer to statistics to update
+    @param ticks time the run took.  */
+void profile_record (profile_t *profile, timer_tick_t ticks);
+
+
+/** Record how late one run started.
+    @param profile pointer to statistics to update
+    @param ticks time between when the run was due and when it started.  */
+void profile_late_record (profile_t *profile, timer_tick_t ticks);
+
+
+/** Get the mean run time.
+    @param profile pointer to statistics
+    @return mean time in ticks or zero if there have been no runs.  */
+timer_tick_t profile_mean (const profile_t *profile);
+
+
+/** Clear the statistics, keeping the name.
+    @param profile pointer to statistics to clear.  */
+void profile_reset (profile_t *profile);
+
+
+/** Print the statistics on one line to stderr (host only).
+    @param profile pointer to statistics
+    @param overruns number of missed deadlines to print.  */
+void profile_print (const profile_t *profile, uint16_t overruns);
+
+
+/** Print a heading for profile_print (host only).  */
+void profile_print_heading (void);
+
+#endif
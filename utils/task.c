@@ -7,11 +7,28 @@
 #include "task.h"
 #include "timer.h"
 
+#if defined (PROFILE_ENABLE) && !defined (__AVR__)
+#include <stdlib.h>
+#endif
+
 
 /** With 16-bit times the maximum value is 32768.  */
 #define TASK_OVERRUN_MAX 32767
 
 
+#if defined (PROFILE_ENABLE) && !defined (__AVR__)
+static const task_t *profile_tasks;
+static uint8_t profile_num_tasks;
+
+
+/** Print the statistics of the scheduled tasks at exit.  */
+static void task_profile_exit (void)
+{
+    task_profile_print (profile_tasks, profile_num_tasks);
+}
+#endif
+
+
 /** Schedule tasks
     @param tasks pointer to array of tasks (the highest priority
                  task comes first)
@@ -27,25 +44,47 @@ void task_schedule (task_t *tasks, uint8_t num_tasks)
     timer_init ();
     now = timer_get ();
 
+#if defined (PROFILE_ENABLE) && !defined (__AVR__)
+    profile_tasks = tasks;
+    profile_num_tasks = num_tasks;
+    atexit (task_profile_exit);
+#endif
+
     /* Start by scheduling the first task.  */
     next_task = tasks;
 
     while (1)
     {
         timer_tick_t sleep_min;
+        timer_tick_t overrun;
 
         /* Wait until the next task is ready to run.  */
         timer_wait_until (next_task->reschedule);
 
         /* Schedule the task.  */
+        PROFILE_START (&next_task->profile);
+        PROFILE_LATE (&next_task->profile, next_task->reschedule);
         next_task->func (next_task->data);
+        PROFILE_STOP (&next_task->profile);
 
-        /* Update the reschedule time.  */
+        /* Update the reschedule time.  This is relative to when the
+           task was due rather than when it ran to avoid drift.  */
         next_task->reschedule += next_task->period;
 
         sleep_min = ~0;
         now = timer_get ();
 
+        /* If the task is already due again it has missed a deadline.
+           When more than a whole period behind, skip the missed runs
+           instead of trying to catch up.  */
+        overrun = now - next_task->reschedule;
+        if (overrun < TASK_OVERRUN_MAX)
+        {
+            next_task->overruns++;
+            if (overrun >= next_task->period)
+                next_task->reschedule = now;
+        }
+
         /* Search array of tasks.  Schedule the first task (highest priority)
            that needs to run otherwise wait until first task ready.  */
         for (i = 0; i < num_tasks; i++)
@@ -74,3 +113,41 @@ void task_schedule (task_t *tasks, uint8_t num_tasks)
         }
     }
 }
+
+
+/** Change the period of a task.
+    @param task pointer to task to modify
+    @param period new period in ticks.  */
+void task_period_set (task_t *task, timer_tick_t period)
+{
+    /* Keep the phase of the task by moving its next run relative to
+       when it was last due.  */
+    task->reschedule += period - task->period;
+    task->period = period;
+}
+
+
+#ifdef PROFILE_ENABLE
+/** Get the execution statistics of a task.
+    @param task pointer to task
+    @return pointer to statistics.  */
+const profile_t *task_profile_get (const task_t *task)
+{
+    return &task->profile;
+}
+
+
+#ifndef __AVR__
+/** Print the execution statistics of tasks to stderr.
+    @param tasks pointer to array of tasks
+    @param num_tasks number of tasks.  */
+void task_profile_print (const task_t *tasks, uint8_t num_tasks)
+{
+    uint8_t i;
+
+    profile_print_heading ();
+    for (i = 0; i < num_tasks; i++)
+        profile_print (&tasks[i].profile, tasks[i].overruns);
+}
+#endif
+#endif
@@ -9,6 +9,20 @@
     of tasks to schedule.  There is no pre-emption; a task can hog the CPU.
     The tasks at the start of the array have a higher priority.
 
+    Each task is rescheduled by adding its period to the time it was
+    due, not the time it ran, so the schedule does not drift.  If a
+    task is already due again when it finishes, its overruns counter
+    is incremented.  If a whole period has been lost, the missed runs
+    are dropped rather than run back to back.
+
+    When PROFILE_ENABLE is defined, the scheduler also records how
+    long each run of each task takes and how late it started after it
+    was due (see profile.h).  Name a task's
+    statistics with TASK_PROFILE in its initialiser; this expands to
+    nothing when profiling is disabled.  On the host, the statistics
+    of every task are printed when the program exits.  On target, they
+    can be read with task_profile_get.
+
     Each task must maintain its own state; either using static local
     variables, file variables, or dynamically using the generic pointer
     passed when the task is called.
@@ -102,11 +116,20 @@
 
 #include "system.h"
 #include "timer.h"
+#include "profile.h"
 
 
 #define TASK_RATE TIMER_RATE
 
 
+/** Name a task's execution statistics in a task_t initialiser.  */
+#ifdef PROFILE_ENABLE
+#define TASK_PROFILE(NAME) .profile = PROFILE_INIT (NAME)
+#else
+#define TASK_PROFILE(NAME)
+#endif
+
+
 /** Task function prototype.  */
 typedef void (* task_func_t)(void *data);
 
@@ -122,6 +145,13 @@ typedef struct task_struct
     timer_tick_t period;    
     /** When to reschedule.  */
     timer_tick_t reschedule;
+    /** Number of times the task was still running (or waiting to
+        run) when it was next due.  */
+    uint16_t overruns;
+#ifdef PROFILE_ENABLE
+    /** Execution time statistics.  */
+    profile_t profile;
+#endif
 } task_t;
 
 
@@ -133,5 +163,29 @@ typedef struct task_struct
 */
 void task_schedule (task_t *tasks, uint8_t num_tasks);
 
+
+/** Change the period of a task.  This can be called while the
+    scheduler is running, say from another task.  The next run is
+    moved so that it occurs the new period after the last time the
+    task was due.
+    @param task pointer to task to modify
+    @param period new period in ticks.  */
+void task_period_set (task_t *task, timer_tick_t period);
+
+
+#ifdef PROFILE_ENABLE
+/** Get the execution statistics of a task.  This is intended as a
+    debug call on target.
+    @param task pointer to task
+    @return pointer to statistics.  */
+const profile_t *task_profile_get (const task_t *task);
+
+
+/** Print the execution statistics of tasks to stderr (host only).
+    @param tasks pointer to array of tasks
+    @param num_tasks number of tasks.  */
+void task_profile_print (const task_t *tasks, uint8_t num_tasks);
+#endif
+
 #endif
 
@@ -12,6 +12,11 @@
 
 enum {TINYGL_SPEED_DEFAULT = 20};
 
+/** Largest font element, in either direction, that is cached and
+    drawn as a bitmap, one byte per column.  Larger fonts are drawn a
+    pixel at a time.  */
+enum {TINYGL_GLYPH_SIZE_MAX = 7};
+
 typedef struct tinygl_state_struct
 {
     tinygl_text_mode_t mode;
@@ -20,10 +25,22 @@ typedef struct tinygl_state_struct
     uint16_t speed;
     font_t *font;
     uint16_t update_rate;
-    uint8_t message_index;
+    /* In scroll mode, the character at the edge of the display where
+       text appears.  */
+    uint16_t message_index;
     uint8_t message_repeats;
     uint16_t text_advance_period;
+    /* Column of the character at message_index; negative for the
+       blank columns before a long message.  */
     int8_t scroll_pos;
+    /* Columns to scroll at the next advance: the whole window to start
+       with, then one.  */
+    uint8_t scroll_steps;
+    /* Blank columns to scroll in after the end of the message before
+       it has gone.  */
+    uint8_t scroll_tail;
+    /* Message in program memory or 0 for the copy in message.  */
+    const char *message_P;
     char message[TINYGL_MESSAGE_SIZE];
 } tinygl_state_t;
 
@@ -36,6 +53,21 @@ static tinygl_state_t tinygl =
 };
 
 
+/** A character drawn in the current font and direction, as the
+    bitmap passed to display_blit.  */
+typedef struct tinygl_glyph_struct
+{
+    char ch;
+    uint8_t bitmap[TINYGL_GLYPH_SIZE_MAX + 1];
+} tinygl_glyph_t;
+
+
+/** Glyph cache, indexed by the low bits of the character.  Scrolling
+    text draws the same few characters over and over, so most are
+    copied straight from here.  An entry for character 0 is empty.  */
+static tinygl_glyph_t tinygl_glyphs[TINYGL_GLYPH_CACHE_SIZE];
+
+
 /** Set pixel.
     @param pos coordinates of point
     @param pixel_value pixel value.  */
@@ -54,6 +86,24 @@ tinygl_pixel_value_t tinygl_pixel_get (tinygl_point_t pos)
 }
 
 
+/** Set brightness of pixel.
+    @param pos coordinates of point
+    @param level brightness, 0 to TINYGL_PIXEL_LEVEL_MAX.  */
+void tinygl_pixel_level_set (tinygl_point_t pos, uint8_t level)
+{
+    display_pixel_level_set (pos.x, pos.y, level);
+}
+
+
+/** Get brightness of pixel.
+    @param pos coordinates of point
+    @return brightness, 0 to TINYGL_PIXEL_LEVEL_MAX.  */
+uint8_t tinygl_pixel_level_get (tinygl_point_t pos)
+{
+    return display_pixel_level_get (pos.x, pos.y);
+}
+
+
 /** Draw point.
     @param pos coordinates of point
     @param pixel_value pixel value for line.  */
@@ -126,6 +176,47 @@ void tinygl_draw_line (tinygl_point_t pos1, tinygl_point_t pos2,
 }
 
 
+/** Get bit pattern for the rows between two coordinates inclusive,
+    clipped to the display.
+    @param y1 first row
+    @param y2 last row
+    @return column bit pattern.  */
+static uint8_t tinygl_rows_mask (tinygl_coord_t y1, tinygl_coord_t y2)
+{
+    if (y1 > y2)
+    {
+        tinygl_coord_t tmp = y1;
+
+        y1 = y2;
+        y2 = tmp;
+    }
+
+    if (y1 < 0)
+        y1 = 0;
+    if (y2 >= TINYGL_HEIGHT)
+        y2 = TINYGL_HEIGHT - 1;
+    if (y1 > y2)
+        return 0;
+
+    return (BIT (y2 + 1) - 1) & ~(BIT (y1) - 1);
+}
+
+
+/** Draw the pixels of a column that are set in a pattern.
+    @param x column
+    @param pattern column bit pattern, bit 0 is the top row
+    @param pixel_value pixel value to draw.  */
+static void tinygl_column_draw (tinygl_coord_t x, uint8_t pattern,
+                                tinygl_pixel_value_t pixel_value)
+{
+    if (x < 0)
+        return;
+
+    display_column_level_set (x, pattern,
+                              pixel_value ? DISPLAY_LEVEL_MAX : 0);
+}
+
+
 /** Draw box.
     @param tl coordinates of top left corner of box
     @param br coordinates of bottom right of box
@@ -133,10 +224,39 @@ void tinygl_draw_line (tinygl_point_t pos1, tinygl_point_t pos2,
 void tinygl_draw_box (tinygl_point_t tl, tinygl_point_t br,
                       tinygl_pixel_value_t pixel_value)
 {
-    tinygl_draw_line (tl, tinygl_point (br.x, tl.y), pixel_value);
-    tinygl_draw_line (tl, tinygl_point (tl.x, br.y), pixel_value);
-    tinygl_draw_line (tinygl_point (br.x, tl.y), br, pixel_value);
-    tinygl_draw_line (tinygl_point (tl.x, br.y), br, pixel_value);
+    tinygl_coord_t x1;
+    tinygl_coord_t x2;
+    tinygl_coord_t x;
+    uint8_t sides;
+    uint8_t ends;
+
+    x1 = tl.x < br.x ? tl.x : br.x;
+    x2 = tl.x < br.x ? br.x : tl.x;
+
+    /* The left and right sides span every row of the box; the
+       columns between only have the top and bottom rows.  */
+    sides = tinygl_rows_mask (tl.y, br.y);
+    ends = tinygl_rows_mask (tl.y, tl.y) | tinygl_rows_mask (br.y, br.y);
+
+    tinygl_column_draw (x1, sides, pixel_value);
+    for (x = x1 + 1; x < x2 && x < TINYGL_WIDTH; x++)
+        tinygl_column_draw (x, ends, pixel_value);
+    if (x2 != x1)
+        tinygl_column_draw (x2, sides, pixel_value);
+}
+
+
+/** Draw bitmap.  Pixels within the bitmap's rectangle are replaced
+    and the parts off the display are clipped.
+    @param bitmap column-major bitmap, one byte per column with bit 0
+    the top row
+    @param width number of columns in bitmap
+    @param height number of rows in bitmap (at most 8)
+    @param pos coordinates of top left of bitmap.  */
+void tinygl_draw_bitmap (const uint8_t *bitmap, uint8_t width,
+                         uint8_t height, tinygl_point_t pos)
+{
+    display_blit (pos.x, pos.y, bitmap, width, height);
 }
 
 
@@ -146,27 +266,89 @@ void tinygl_clear (void)
     display_clear ();
 
     /* Stop message display.  */
+    tinygl.message_P = 0;
     tinygl.message[0] = 0;
     tinygl.message_index = 0;
+    tinygl.scroll_tail = 0;
 }
 
 
-/** Determine if pixel on or off.
-    @param ch character to display
-    @param col column of font element
-    @param row row of font element
-    @return 1 if pixel on; if pixel out of bounds return 0.  */
-static bool tinygl_font_pixel_get (char ch, uint8_t col, uint8_t row)
+/** Empty the glyph cache.  */
+static void tinygl_glyphs_clear (void)
 {
-    return font_pixel_get (tinygl.font, ch, col, row);
+    uint8_t i;
+
+    for (i = 0; i < TINYGL_GLYPH_CACHE_SIZE; i++)
+        tinygl_glyphs[i].ch = 0;
 }
 
 
-/** Draw character using current font.
+/** Draw a character, with the blank column after it, as a bitmap for
+    display_blit in the current direction.
+    @param ch character to draw
+    @param bitmap array of TINYGL_GLYPH_SIZE_MAX + 1 bytes to fill.  */
+static void tinygl_glyph_render (char ch, uint8_t *bitmap)
+{
+    uint8_t width;
+    uint8_t height;
+
+    width = tinygl.font->width;
+    height = tinygl.font->height;
+
+    if (tinygl.dir == TINYGL_TEXT_DIR_ROTATE)
+    {
+        uint8_t columns[TINYGL_GLYPH_SIZE_MAX];
+        uint8_t x;
+        uint8_t y;
+
+        font_columns_get (tinygl.font, ch, columns);
+
+        /* Font row x becomes display column pos.x + x and font column
+           y becomes display row pos.y - y.  Bit 0 is the blank row
+           above the character.  */
+        for (x = 0; x < height; x++)
+        {
+            bitmap[x] = 0;
+            for (y = 0; y < width; y++)
+            {
+                if (columns[y] & BIT (x))
+                    bitmap[x] |= BIT (width - y);
+            }
+        }
+    }
+    else
+    {
+        font_columns_get (tinygl.font, ch, bitmap);
+
+        /* Blank column.  */
+        bitmap[width] = 0;
+    }
+}
+
+
+/** Get the bitmap for a character, drawing it if it is not cached.
+    @param ch character to draw
+    @return bitmap for display_blit.  */
+static const uint8_t *tinygl_glyph_get (char ch)
+{
+    tinygl_glyph_t *glyph;
+
+    glyph = &tinygl_glyphs[(uint8_t) ch & (TINYGL_GLYPH_CACHE_SIZE - 1)];
+    if (glyph->ch != ch || !ch)
+    {
+        tinygl_glyph_render (ch, glyph->bitmap);
+        glyph->ch = ch;
+    }
+    return glyph->bitmap;
+}
+
+
+/** Draw character using current font a pixel at a time, for fonts
+    too big to draw as a bitmap.
     @param ch character to draw
     @param pos coordinates of top left position
     @return position to draw next character.  */
-tinygl_point_t tinygl_draw_char (char ch, tinygl_point_t pos)
+static tinygl_point_t tinygl_draw_char_pixels (char ch, tinygl_point_t pos)
 {
     uint8_t x;
     uint8_t y;
@@ -178,7 +360,7 @@ tinygl_point_t tinygl_draw_char (char ch, tinygl_point_t pos)
             for (x = 0; x < tinygl.font->height; x++)
             {
                 tinygl_draw_point (tinygl_point (x + pos.x, pos.y),
-                                   tinygl_font_pixel_get (ch, y, x));
+                                   font_pixel_get (tinygl.font, ch, y, x));
             }
             pos.y--;
         }
@@ -186,7 +368,6 @@ tinygl_point_t tinygl_draw_char (char ch, tinygl_point_t pos)
         /* Draw blank row.  */
         for (x = 0; x < tinygl.font->height; x++)
             tinygl_draw_point (tinygl_point (x + pos.x, pos.y), 0);
-
         pos.y--;
     }
     else
@@ -196,11 +377,11 @@ tinygl_point_t tinygl_draw_char (char ch, tinygl_point_t pos)
             for (y = 0; y < tinygl.font->height; y++)
             {
                 tinygl_draw_point (tinygl_point (pos.x, y + pos.y),
-                                   tinygl_font_pixel_get (ch, x, y));
+                                   font_pixel_get (tinygl.font, ch, x, y));
             }
             pos.x++;
         }
-        
+
         /* Draw blank column.  */
         for (y = 0; y < tinygl.font->height; y++)
             tinygl_draw_point (tinygl_point (pos.x, y + pos.y), 0);
@@ -210,6 +391,40 @@ tinygl_point_t tinygl_draw_char (char ch, tinygl_point_t pos)
 }
 
 
+/** Draw character using current font.
+    @param ch character to draw
+    @param pos coordinates of top left position
+    @return position to draw next character.  */
+tinygl_point_t tinygl_draw_char (char ch, tinygl_point_t pos)
+{
+    const uint8_t *bitmap;
+    uint8_t width;
+    uint8_t height;
+
+    width = tinygl.font->width;
+    height = tinygl.font->height;
+
+    /* With the blank separator each drawn column needs width + 1
+       bits when rotated and height bits otherwise.  */
+    if (width > TINYGL_GLYPH_SIZE_MAX || height > TINYGL_GLYPH_SIZE_MAX)
+        return tinygl_draw_char_pixels (ch, pos);
+
+    bitmap = tinygl_glyph_get (ch);
+
+    if (tinygl.dir == TINYGL_TEXT_DIR_ROTATE)
+    {
+        display_blit (pos.x, pos.y - width, bitmap, height, width + 1);
+        pos.y -= width + 1;
+    }
+    else
+    {
+        display_blit (pos.x, pos.y, bitmap, width + 1, height);
+        pos.x += width + 1;
+    }
+    return pos;
+}
+
+
 /** Draw string (well, as much as possible) using current font.
     @param str string to draw
     @param pos coordinates of top left position
@@ -232,44 +447,180 @@ uint8_t tinygl_draw_string (const char *str, tinygl_point_t pos)
 }
 
 
-/** Advance message.  */
-static void tinygl_text_advance (void)
+/** Get a character of the message.
+    @param index index of character
+    @return character or 0 past the end of the message.  */
+static char tinygl_message_char (uint16_t index)
+{
+    if (tinygl.message_P)
+        return pgm_read_byte (tinygl.message_P + index);
+
+    if (index >= TINYGL_MESSAGE_SIZE)
+        return 0;
+    return tinygl.message[index];
+}
+
+
+/** Get the number of display columns (or rows when rotated) that
+    scrolling text passes through.  */
+static uint8_t tinygl_scroll_size (void)
 {
-    if (!tinygl.message[tinygl.message_index])
+    if (tinygl.dir == TINYGL_TEXT_DIR_ROTATE)
+        return tinygl.pos.y < 0 ? 0 : tinygl.pos.y + 1;
+
+    return tinygl.pos.x >= TINYGL_WIDTH ? 0 : TINYGL_WIDTH - tinygl.pos.x;
+}
+
+
+/** Get one column of a character in the current font.
+    @param ch character
+    @param col font column; the font width gives the blank column
+    @return pixels in the column, bit n for font row n.  */
+static uint16_t tinygl_char_column (char ch, uint8_t col)
+{
+    const uint8_t *bitmap;
+    uint16_t column = 0;
+    uint8_t width;
+    uint8_t height;
+    uint8_t y;
+
+    width = tinygl.font->width;
+    height = tinygl.font->height;
+
+    if (col >= width)
+        return 0;
+
+    if (width > TINYGL_GLYPH_SIZE_MAX || height > TINYGL_GLYPH_SIZE_MAX)
+    {
+        /* Too big to cache so read the font; rows past the bottom of
+           the display cannot be seen anyway.  */
+        for (y = 0; y < height && y < 16; y++)
+        {
+            if (font_pixel_get (tinygl.font, ch, col, y))
+                column |= 1u << y;
+        }
+        return column;
+    }
+
+    bitmap = tinygl_glyph_get (ch);
+    if (tinygl.dir != TINYGL_TEXT_DIR_ROTATE)
+        return bitmap[col];
+
+    /* Font column col is bit width - col of the rotated glyph, with
+       the blank column in bit 0.  */
+    for (y = 0; y < height; y++)
+        column |= ((bitmap[y] >> (width - col)) & 1) << y;
+    return column;
+}
+
+
+/** Scroll the text along by one column (or row when rotated) and
+    draw the column of the message that appears at the edge.  Only
+    that column is drawn, whatever the width of the font.  */
+static void tinygl_scroll_step (void)
+{
+    uint16_t line = 0;
+    uint8_t width;
+    uint8_t height;
+    int8_t col;
+    char ch;
+
+    width = tinygl.font->width;
+    height = tinygl.font->height;
+
+    ch = tinygl_message_char (tinygl.message_index);
+    if (!ch && tinygl.message_repeats > 1)
     {
-        if (tinygl.message_repeats <= 1)
-            return;
         tinygl.message_repeats--;
         tinygl.message_index = 0;
+        ch = tinygl_message_char (0);
     }
-    
-    if (tinygl.message[tinygl.message_index])
+
+    col = tinygl.scroll_pos;
+    if (!ch)
     {
-        tinygl_point_t pos;
+        /* Scroll the end of the message off the display.  */
+        if (tinygl.scroll_tail)
+            tinygl.scroll_tail--;
+    }
+    else
+    {
+        if (col >= 0)
+            line = tinygl_char_column (ch, col);
 
-        switch (tinygl.mode)
+        tinygl.scroll_pos++;
+        if (tinygl.scroll_pos > width)
         {
-        case TINYGL_TEXT_MODE_STEP:
-            if (tinygl.scroll_pos != 0)
-                break;
-            
-            tinygl.message_index += 
-                tinygl_draw_string (tinygl.message + tinygl.message_index,
-                                    tinygl.pos) - 1;
-            break;
+            tinygl.scroll_pos = 0;
+            tinygl.message_index++;
+        }
+    }
+
+    if (tinygl.dir == TINYGL_TEXT_DIR_ROTATE)
+    {
+        /* Font row n is display column pos.x + n.  */
+        display_scroll_down (tinygl.pos.x, height,
+                             tinygl_rows_mask (0, tinygl.pos.y), line);
+    }
+    else
+    {
+        uint8_t column;
+
+        column = tinygl.pos.y < 0 ? line >> -tinygl.pos.y
+            : line << tinygl.pos.y;
+
+        display_scroll_left (tinygl.pos.x,
+                             tinygl_rows_mask (tinygl.pos.y,
+                                               tinygl.pos.y + height - 1),
+                             column);
+    }
+}
 
-        case TINYGL_TEXT_MODE_SCROLL:
-            pos = tinygl.pos;
 
-            if (tinygl.dir == TINYGL_TEXT_DIR_ROTATE)
-                pos.y += tinygl.scroll_pos;
-            else
-                pos.x -= tinygl.scroll_pos;
+/** Draw as many characters of the message as will fit.
+    @param index index of first character
+    @param pos coordinates of top left position
+    @return number of whole characters drawn.  */
+static uint8_t tinygl_message_draw (uint16_t index, tinygl_point_t pos)
+{
+    uint8_t count = 0;
+    char ch;
+
+    while ((ch = tinygl_message_char (index)))
+    {
+        pos = tinygl_draw_char (ch, pos);
+        count++;
 
-            /* In scroll mode, display as much as the string that will
-               fit on the display then scroll the reset.  */
-            tinygl_draw_string (tinygl.message + tinygl.message_index, pos);
+        if (pos.x >= TINYGL_WIDTH || pos.y < 0)
             break;
+
+        index++;
+    }
+    return count;
+}
+
+
+/** Advance message.  */
+static void tinygl_text_advance (void)
+{
+    if (!tinygl.font || !tinygl_message_char (0))
+        return;
+
+    switch (tinygl.mode)
+    {
+    case TINYGL_TEXT_MODE_STEP:
+        if (!tinygl_message_char (tinygl.message_index))
+        {
+            if (tinygl.message_repeats <= 1)
+                return;
+            tinygl.message_repeats--;
+            tinygl.message_index = 0;
+        }
+
+        if (tinygl.scroll_pos == 0)
+        {
+            tinygl.message_index +=
+                tinygl_message_draw (tinygl.message_index, tinygl.pos) - 1;
         }
 
         tinygl.scroll_pos++;
@@ -278,67 +629,134 @@ static void tinygl_text_advance (void)
             tinygl.scroll_pos = 0;
             tinygl.message_index++;
         }
+        break;
+
+    case TINYGL_TEXT_MODE_SCROLL:
+        /* Rather than redrawing the visible part of the message, the
+           display is shifted along and one new column drawn.  The
+           first advance fills the display.  */
+        for (; tinygl.scroll_steps && tinygl.scroll_tail; tinygl.scroll_steps--)
+            tinygl_scroll_step ();
+        tinygl.scroll_steps = 1;
+        break;
     }
 }
 
 
-/** Display a message a specified number of times.
-    @param string null terminated message to display
-    @param pos position on screen
-    @param repeats number of times to repeat message.  */
-void tinygl_draw_message (const char *string, tinygl_point_t pos,
-                          uint8_t repeats)
+/** Work out how many display updates there are between message
+    advances for the current speed and font.  */
+static void tinygl_text_period_set (void)
+{
+    if (!tinygl.font || !tinygl.speed)
+        return;
+
+    tinygl.text_advance_period = tinygl.update_rate /
+        (tinygl.speed * tinygl.font->width) * 10;
+}
+
+
+/** Start displaying the message in tinygl.message or
+    tinygl.message_P.  */
+static void tinygl_message_start (tinygl_point_t pos, uint8_t repeats)
 {
     tinygl.message_index = 0;
     tinygl.message_repeats = repeats;
     tinygl.scroll_pos = 0;
+    tinygl.pos = pos;
+
+    tinygl.scroll_steps = tinygl_scroll_size ();
+    tinygl.scroll_tail = tinygl.scroll_steps;
 
     /* Not much we can do without a font.  */
     if (!tinygl.font)
         return;
 
-    tinygl.text_advance_period = tinygl.update_rate / 
-        (tinygl.speed * tinygl.font->width) * 10;
-
-    tinygl.pos = pos;
-
-    strncpy (tinygl.message, string, sizeof (tinygl.message));
+    tinygl_text_period_set ();
 
     if (tinygl.mode == TINYGL_TEXT_MODE_SCROLL)
     {
-        uint8_t message_cols;
-        uint8_t message_len;
+        uint16_t message_cols = 0;
+        uint16_t index;
         uint8_t cols;
 
-        message_len = strlen (string);
-        message_cols = message_len * tinygl.font->width + message_len - 1;
+        for (index = 0; tinygl_message_char (index); index++)
+            message_cols += tinygl.font->width + 1;
 
-        cols = (tinygl.dir == TINYGL_TEXT_DIR_ROTATE) ? TINYGL_HEIGHT 
+        cols = (tinygl.dir == TINYGL_TEXT_DIR_ROTATE) ? TINYGL_HEIGHT
             : TINYGL_WIDTH;
-        if (message_cols > cols)
+
+        /* Start a message that needs scrolling with a couple of blank
+           columns.  */
+        if (message_cols > cols + 1u)
             tinygl.scroll_pos = -2;
     }
 }
 
 
-/** Display a message repeatedly positioned at the top left pixel.
-    @param string null terminated message to display.  */
-void tinygl_text (const char *string)
+/** Display a message a specified number of times.
+    @param string null terminated message to display
+    @param pos position on screen
+    @param repeats number of times to repeat message.  */
+void tinygl_draw_message (const char *string, tinygl_point_t pos,
+                          uint8_t repeats)
+{
+    tinygl.message_P = 0;
+    strncpy (tinygl.message, string, sizeof (tinygl.message));
+
+    tinygl_message_start (pos, repeats);
+}
+
+
+/** Display a message in program memory a specified number of times.
+    The message is read as it is displayed so it can be longer than
+    TINYGL_MESSAGE_SIZE.
+    @param string null terminated message in program memory
+    @param pos position on screen
+    @param repeats number of times to repeat message.  */
+void tinygl_draw_message_P (const char *string, tinygl_point_t pos,
+                            uint8_t repeats)
+{
+    tinygl.message_P = string;
+
+    tinygl_message_start (pos, repeats);
+}
+
+
+/** Get the position of the start of a repeated message.  */
+static tinygl_point_t tinygl_text_pos (void)
 {
     tinygl_point_t pos;
 
     pos.x = 0;
     pos.y = (tinygl.dir == TINYGL_TEXT_DIR_ROTATE) ? TINYGL_HEIGHT - 1 : 0;
+    return pos;
+}
 
-    tinygl_draw_message (string, pos, ~0);
+
+/** Display a message repeatedly positioned at the top left pixel.
+    @param string null terminated message to display.  */
+void tinygl_text (const char *string)
+{
+    tinygl_draw_message (string, tinygl_text_pos (), ~0);
+}
+
+
+/** Display a message in program memory repeatedly positioned at the
+    top left pixel.
+    @param string null terminated message in program memory.  */
+void tinygl_text_P (const char *string)
+{
+    tinygl_draw_message_P (string, tinygl_text_pos (), ~0);
 }
 
 
-/** Set the message update speed.
+/** Set the message update speed.  This can be changed while a
+    message is displayed and applies from the next advance.
     @param speed text advance speed (characters per 10 s).  */
 void tinygl_text_speed_set (uint8_t speed)
 {
     tinygl.speed = speed;
+    tinygl_text_period_set ();
 }
 
 
@@ -354,6 +772,8 @@ void tinygl_text_mode_set (tinygl_text_mode_t mode)
     @param dir display direction.  */
 void tinygl_text_dir_set (tinygl_text_dir_t dir)
 {
+    if (tinygl.dir != dir)
+        tinygl_glyphs_clear ();
     tinygl.dir = dir;
 }
 
@@ -362,11 +782,15 @@ void tinygl_text_dir_set (tinygl_text_dir_t dir)
     @param font pointer to font description.  */
 void tinygl_font_set (font_t *font)
 {
+    if (tinygl.font != font)
+        tinygl_glyphs_clear ();
     tinygl.font = font;
+    tinygl_text_period_set ();
 }
 
 
-/** Update display (refresh display and update message).  */
+/** Update display (show what has been drawn, refresh display and
+    update message).  */
 void tinygl_update (void)
 {
     static uint16_t tick = 0;
@@ -379,6 +803,7 @@ void tinygl_update (void)
         tinygl_text_advance ();
     }
 
+    display_swap ();
     display_update ();
 }
 
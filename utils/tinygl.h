@@ -67,6 +67,13 @@
        }
        @endcode
 
+       In scroll mode, each advance shifts the display along by one
+       column and draws just the column of the message that appears,
+       so the cost does not depend on the font size.  A message
+       declared with PROGMEM can be displayed with tinygl_text_P.  It
+       is read from program memory as it scrolls and so is not limited
+       to TINYGL_MESSAGE_SIZE characters.
+
 */
 
 #ifndef TINYGL_H
@@ -76,20 +83,45 @@
 #include "display.h"
 #include "font.h"
 
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#define PROGMEM
+#define pgm_read_byte(ADDR) (*(const uint8_t *)(ADDR))
+#endif
+
 /** Define size of display.  */
 #define TINYGL_WIDTH DISPLAY_WIDTH
 #define TINYGL_HEIGHT DISPLAY_HEIGHT
 
 
-/** Maximum length of a message to display.  */
+/** Maximum length of a message to display, except for messages in
+    program memory.  */
 #define TINYGL_MESSAGE_SIZE 32
 
 
+/** Number of drawn characters to keep ready to copy to the display,
+    a power of two.  Each takes 9 bytes.  */
+#ifndef TINYGL_GLYPH_CACHE_SIZE
+#define TINYGL_GLYPH_CACHE_SIZE 8
+#endif
+
+#if TINYGL_GLYPH_CACHE_SIZE & (TINYGL_GLYPH_CACHE_SIZE - 1)
+#error TINYGL_GLYPH_CACHE_SIZE must be a power of two
+#endif
+
+
 /** Define a pixel value.  Currently the only supported values are 0
-    for off and 1 for on.  */
+    for off and 1 for on.  On is full brightness when the display has
+    several bit planes; use tinygl_pixel_level_set for other levels.  */
 typedef uint8_t tinygl_pixel_value_t;
 
 
+/** Brightness of a pixel that is fully on.  Unless the display has
+    been built with several bit planes, this is 1.  */
+#define TINYGL_PIXEL_LEVEL_MAX DISPLAY_LEVEL_MAX
+
+
 /** Define a display coordinate.  Note these are signed to allow
     relative coordinates.  */
 typedef int8_t tinygl_coord_t;
@@ -136,7 +168,8 @@ static inline tinygl_point_t tinygl_point (tinygl_coord_t x, tinygl_coord_t y)
 }
 
 
-/** Set the message update speed.
+/** Set the message update speed.  This can be changed while a
+    message is displayed and applies from the next advance.
     @param speed text advance speed (characters per 10 s).  */
 void tinygl_text_speed_set (uint8_t speed);
 
@@ -178,11 +211,26 @@ void tinygl_draw_message (const char *string, tinygl_point_t pos,
                           uint8_t repeats);
 
 
+/** Display a message in program memory a specified number of times.
+    The message is read as it is displayed so it can be longer than
+    TINYGL_MESSAGE_SIZE.
+    @param string null terminated message in program memory
+    @param pos position on screen
+    @param repeats number of times to repeat message.  */
+void tinygl_draw_message_P (const char *string, tinygl_point_t pos,
+                            uint8_t repeats);
+
+
 /** Display a message repeatedly.
     @param string null terminated message to display.  */
 void tinygl_text (const char *string);
 
 
+/** Display a message in program memory repeatedly.
+    @param string null terminated message in program memory.  */
+void tinygl_text_P (const char *string);
+
+
 /** Draw point.
     @param pos coordinates of point
     @param pixel_value pixel value to draw point.  */
@@ -201,6 +249,18 @@ void tinygl_pixel_set (tinygl_point_t pos, tinygl_pixel_value_t pixel_value);
 tinygl_pixel_value_t tinygl_pixel_get (tinygl_point_t pos);
 
 
+/** Set brightness of pixel.
+    @param pos coordinates of point
+    @param level brightness, 0 to TINYGL_PIXEL_LEVEL_MAX.  */
+void tinygl_pixel_level_set (tinygl_point_t pos, uint8_t level);
+
+
+/** Get brightness of pixel.
+    @param pos coordinates of point
+    @return brightness, 0 to TINYGL_PIXEL_LEVEL_MAX.  */
+uint8_t tinygl_pixel_level_get (tinygl_point_t pos);
+
+
 /** Draw line.
     @param pos1 coordinates of start of line
     @param pos2 coordinates of end of line
@@ -217,6 +277,17 @@ void tinygl_draw_box (tinygl_point_t tl, tinygl_point_t br,
                       tinygl_pixel_value_t pixel_value);
 
 
+/** Draw bitmap.  Pixels within the bitmap's rectangle are replaced
+    and the parts off the display are clipped.
+    @param bitmap column-major bitmap, one byte per column with bit 0
+    the top row
+    @param width number of columns in bitmap
+    @param height number of rows in bitmap (at most 8)
+    @param pos coordinates of top left of bitmap.  */
+void tinygl_draw_bitmap (const uint8_t *bitmap, uint8_t width,
+                         uint8_t height, tinygl_point_t pos);
+
+
 /** Clear display.  */
 void tinygl_clear (void);
 